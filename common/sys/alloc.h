@@ -19,6 +19,7 @@
 #include "platform.h"
 #include <vector>
 #include <set>
+#include <atomic>
 
 namespace embree
 {
@@ -119,7 +120,7 @@ namespace embree
       bool hugepages;
     };
 
-  /*! allocator for IDs */
+  /*! allocator for IDs, allocateRange can get called concurrently, all other functions have to get locked */
   template<typename T, size_t max_id>
     struct IDPool
     {
@@ -140,12 +141,18 @@ namespace embree
 
         /* allocate new ID */
         else
-        {
-          if (size_t(nextID)+1 > max_id)
+          return allocateRange(1);
+      }
+
+      /* allocates num consecutive new IDs and returns the first one */
+      T allocateRange(T num)
+      {
+        T id = nextID.load();
+        do {
+          if (size_t(id)+size_t(num) > max_id)
             return -1;
-          
-          return nextID++;
-        }
+        } while (!nextID.compare_exchange_weak(id,id+num));
+        return id;
       }
 
       /* adds an ID provided by the user */
@@ -154,22 +161,23 @@ namespace embree
         if (id > max_id)
           return false;
         
-        /* check if ID should be in IDs set */
-        if (id < nextID) {
-          auto p = IDs.find(id);
-          if (p == IDs.end()) return false;
-          IDs.erase(p);
-          return true;
-        }
-
-        /* otherwise increase ID set */
-        else
+        for (T next = nextID.load();;)
         {
-          for (T i=nextID; i<id; i++) {
-            IDs.insert(i);
+          /* check if ID should be in IDs set */
+          if (id < next) {
+            auto p = IDs.find(id);
+            if (p == IDs.end()) return false;
+            IDs.erase(p);
+            return true;
+          }
+
+          /* otherwise increase ID set */
+          if (nextID.compare_exchange_weak(next,id+1)) {
+            for (T i=next; i<id; i++) {
+              IDs.insert(i);
+            }
+            return true;
           }
-          nextID = id+1;
-          return true;
         }
       }
 
@@ -182,7 +190,7 @@ namespace embree
 
     private:
       std::set<T> IDs;   //!< stores deallocated IDs to be reused
-      T nextID;          //!< next ID to use when IDs vector is empty
+      std::atomic<T> nextID; //!< next ID to use when IDs vector is empty
     };
 }
 
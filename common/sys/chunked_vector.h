@@ -0,0 +1,92 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "intrinsics.h"
+#include <atomic>
+
+namespace embree
+{
+  /*! vector that grows in chunks of doubling size, items never get moved,
+   *  thus multiple threads can grow the vector and write to different
+   *  items concurrently */
+  template<typename T>
+    class chunked_vector
+    {
+      static const size_t BASE_CHUNK_BITS = 8;                     //!< first chunk stores 256 items
+      static const size_t MAX_CHUNKS = 8*sizeof(size_t)-BASE_CHUNK_BITS;
+
+    public:
+      typedef T value_type;
+
+      chunked_vector () : size_active(0) {
+        for (size_t i=0; i<MAX_CHUNKS; i++) chunks[i] = nullptr;
+      }
+
+      ~chunked_vector () {
+        clear();
+      }
+
+    private:
+      chunked_vector (const chunked_vector& other) DELETED; // do not implement
+      chunked_vector& operator= (const chunked_vector& other) DELETED; // do not implement
+
+    public:
+
+      __forceinline size_t size() const { return size_active.load(std::memory_order_relaxed); }
+
+      __forceinline       T& operator[](size_t i)       { assert(i < size()); const size_t c = chunkID(i); return chunks[c].load(std::memory_order_relaxed)[i-chunkBegin(c)]; }
+      __forceinline const T& operator[](size_t i) const { assert(i < size()); const size_t c = chunkID(i); return chunks[c].load(std::memory_order_relaxed)[i-chunkBegin(c)]; }
+
+      /*! makes the items [0,new_size) accessible, can get called concurrently */
+      void grow(size_t new_size)
+      {
+        if (new_size == 0) return;
+        
+        /* allocate missing chunks, the loser of a race frees its chunk again */
+        for (size_t c=0, e=chunkID(new_size-1); c<=e; c++)
+        {
+          if (chunks[c].load()) continue;
+          T* chunk = new T[chunkSize(c)]();
+          T* expected = nullptr;
+          if (!chunks[c].compare_exchange_strong(expected,chunk))
+            delete[] chunk;
+        }
+
+        size_t cur_size = size_active.load();
+        while (cur_size < new_size && !size_active.compare_exchange_weak(cur_size,new_size));
+      }
+
+      void clear()
+      {
+        for (size_t c=0; c<MAX_CHUNKS; c++) {
+          delete[] chunks[c].load();
+          chunks[c] = nullptr;
+        }
+        size_active = 0;
+      }
+
+    private:
+      static __forceinline size_t chunkID   (size_t i) { return __bsr((i >> BASE_CHUNK_BITS)+1); }
+      static __forceinline size_t chunkBegin(size_t c) { return ((size_t(1) << c)-1) << BASE_CHUNK_BITS; }
+      static __forceinline size_t chunkSize (size_t c) { return size_t(1) << (c+BASE_CHUNK_BITS); }
+
+    private:
+      std::atomic<T*> chunks[MAX_CHUNKS];   //!< chunk c stores items [chunkBegin(c),chunkBegin(c+1))
+      std::atomic<size_t> size_active;      //!< number of accessible items
+    };
+}
@@ -399,6 +399,18 @@ namespace embree
   void sleepSeconds(double t) {
     Sleep(DWORD(1000.0*t));
   }
+
+  CPUTopology getCPUTopology(ssize_t cpuID) {
+    return CPUTopology();
+  }
+
+  unsigned int getNumberOfNUMANodes() {
+    return 1;
+  }
+
+  ssize_t getCurrentCPU() {
+    return GetCurrentProcessorNumber();
+  }
 }
 #endif
 
@@ -410,6 +422,9 @@ namespace embree
 
 #include <stdio.h>
 #include <unistd.h>
+#include <sched.h>
+#include <vector>
+#include <algorithm>
 
 namespace embree
 {
@@ -422,6 +437,98 @@ namespace embree
       return std::string();
     return std::string(buf);
   }
+
+  /* reads the first integer of a sysfs file, CPU lists like 0-7,16-23 return their first CPU */
+  static int readFirstInt(const std::string& fileName)
+  {
+    FILE* file = fopen(fileName.c_str(),"r");
+    if (!file) return -1;
+    int i = -1;
+    if (fscanf(file,"%d",&i) != 1) i = -1;
+    fclose(file);
+    return i;
+  }
+
+  static CPUTopology readCPUTopology(size_t cpuID)
+  {
+    const std::string cpu = "/sys/devices/system/cpu/cpu" + toString(cpuID);
+    CPUTopology topology;
+    topology.package = readFirstInt(cpu + "/topology/physical_package_id");
+    topology.core    = readFirstInt(cpu + "/topology/core_id");
+
+    /* the first CPU sharing the highest level cache identifies the core complex */
+    for (int i=0, maxLevel=-1;; i++)
+    {
+      const std::string cache = cpu + "/cache/index" + toString(i);
+      const int level = readFirstInt(cache + "/level");
+      if (level == -1) break;
+      if (level < maxLevel) continue;
+      maxLevel = level;
+      topology.cache = readFirstInt(cache + "/shared_cpu_list");
+    }
+    return topology;
+  }
+
+  /* parses CPU lists of the form 0-7,16-23 */
+  static std::vector<int> readCPUList(const std::string& fileName)
+  {
+    std::vector<int> list;
+    FILE* file = fopen(fileName.c_str(),"r");
+    if (!file) return list;
+    int begin = 0, end = 0;
+    while (fscanf(file,"%d",&begin) == 1)
+    {
+      end = begin;
+      int c = fgetc(file);
+      if (c == '-') {
+        if (fscanf(file,"%d",&end) != 1) break;
+        c = fgetc(file);
+      }
+      for (int i=begin; i<=end; i++) list.push_back(i);
+      if (c != ',') break;
+    }
+    fclose(file);
+    return list;
+  }
+
+  static const std::vector<CPUTopology>& getTopologyTable()
+  {
+    static const std::vector<CPUTopology> topology = [] () 
+    {
+      std::vector<CPUTopology> topology(getNumberOfLogicalThreads());
+      for (size_t i=0; i<topology.size(); i++)
+        topology[i] = readCPUTopology(i);
+
+      /* assign NUMA nodes */
+      for (int node : readCPUList("/sys/devices/system/node/online")) {
+        for (int cpuID : readCPUList("/sys/devices/system/node/node" + toString(node) + "/cpulist"))
+          if (cpuID >= 0 && size_t(cpuID) < topology.size()) topology[cpuID].node = node;
+      }
+      return topology;
+    }();
+    return topology;
+  }
+
+  CPUTopology getCPUTopology(ssize_t cpuID)
+  {
+    const std::vector<CPUTopology>& topology = getTopologyTable();
+    if (cpuID < 0 || size_t(cpuID) >= topology.size()) return CPUTopology();
+    return topology[cpuID];
+  }
+
+  unsigned int getNumberOfNUMANodes()
+  {
+    static const unsigned int numNodes = [] () {
+      int maxNode = 0;
+      for (const CPUTopology& cpu : getTopologyTable()) maxNode = std::max(maxNode,cpu.node);
+      return unsigned(maxNode+1);
+    }();
+    return numNodes;
+  }
+
+  ssize_t getCurrentCPU() {
+    return sched_getcpu();
+  }
 }
 
 #endif
@@ -507,6 +614,20 @@ namespace embree
   void sleepSeconds(double t) {
     usleep(1000000.0*t);
   }
+
+#if !defined(__LINUX__)
+  CPUTopology getCPUTopology(ssize_t cpuID) {
+    return CPUTopology();
+  }
+
+  unsigned int getNumberOfNUMANodes() {
+    return 1;
+  }
+
+  ssize_t getCurrentCPU() {
+    return -1;
+  }
+#endif
 }
 #endif
 
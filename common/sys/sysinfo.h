@@ -161,6 +161,27 @@ namespace embree
   /*! return the number of logical threads of the system */
   unsigned int getNumberOfLogicalThreads();
   
+  /*! topology of a logical CPU, unknown IDs are -1 */
+  struct CPUTopology
+  {
+    CPUTopology ()
+      : package(-1), core(-1), cache(-1), node(-1) {}
+
+    int package;   //!< ID of the socket
+    int core;      //!< ID of the physical core inside the socket, SMT siblings share it
+    int cache;     //!< ID of the last level cache domain (core complex)
+    int node;      //!< ID of the NUMA node
+  };
+
+  /*! returns the topology of some logical CPU */
+  CPUTopology getCPUTopology(ssize_t cpuID);
+
+  /*! returns the number of NUMA nodes of the system, at least 1 */
+  unsigned int getNumberOfNUMANodes();
+
+  /*! returns the logical CPU the calling thread runs on, or -1 if unknown */
+  ssize_t getCurrentCPU();
+
   /*! returns the size of the terminal window in characters */
   int getTerminalWidth();
 
@@ -17,11 +17,16 @@
 #include "taskschedulerinternal.h"
 #include "../math/math.h"
 #include "../sys/sysinfo.h"
+#include "../sys/regression.h"
 #include <algorithm>
 
 namespace embree
 {
   size_t TaskScheduler::g_numThreads = 0;
+  std::atomic<int> TaskScheduler::g_idle_policy(TaskScheduler::IDLE_SPIN);
+  std::atomic<size_t> TaskScheduler::g_idle_wakeups(0);
+  std::atomic<size_t> TaskScheduler::g_idle_latency_sum(0);
+  std::atomic<size_t> TaskScheduler::g_idle_latency_max(0);
   __thread TaskScheduler* TaskScheduler::g_instance = nullptr;
   __thread TaskScheduler::Thread* TaskScheduler::thread_local_thread = nullptr;
   TaskScheduler::ThreadPool* TaskScheduler::threadPool = nullptr;
@@ -29,10 +34,12 @@ namespace embree
   template<typename Predicate, typename Body>
   __forceinline void TaskScheduler::steal_loop(Thread& thread, const Predicate& pred, const Body& body)
   {
+    const int idlePolicy = g_idle_policy;
+    const size_t yieldRounds = idlePolicy == IDLE_SLEEP ? 1 : 32;
     while (true)
     {
       /*! some rounds that yield */
-      for (size_t i=0; i<32; i++)
+      for (size_t i=0; i<yieldRounds; i++)
       {
         /*! some spinning rounds */
         const size_t threadCount = thread.threadCount();
@@ -46,9 +53,62 @@ namespace embree
         }
         yield();
       }
+
+      /*! sleep until other threads signal new work */
+      if (idlePolicy != IDLE_SPIN)
+      {
+        const size_t epoch = thread.scheduler->idle_begin();
+
+        /* work might have arrived before we registered as idle thread, thus check once more */
+        if (!pred()) {
+          thread.scheduler->idle_end();
+          return;
+        }
+        if (thread.scheduler->steal_from_other_threads(thread)) {
+          thread.scheduler->idle_end();
+          body();
+          continue;
+        }
+        thread.scheduler->idle_wait(epoch);
+      }
     }
   }
 
+  size_t TaskScheduler::idle_begin()
+  {
+    const size_t epoch = idleEpoch;
+    idleThreads++;
+    return epoch;
+  }
+
+  void TaskScheduler::idle_end() {
+    idleThreads--;
+  }
+
+  void TaskScheduler::idle_wait(size_t epoch)
+  {
+    {
+      Lock<MutexSys> lock(idleMutex);
+      idleCondition.wait(idleMutex, [&] () { return idleEpoch != epoch; });
+
+      /* record time from wakeup until this thread runs again */
+      const size_t latency = size_t(max(0.0,getSeconds()-idleWakeupTime)*1E9);
+      g_idle_wakeups++;
+      g_idle_latency_sum += latency;
+      size_t maxLatency = g_idle_latency_max;
+      while (latency > maxLatency && !g_idle_latency_max.compare_exchange_weak(maxLatency,latency));
+    }
+    idleThreads--;
+  }
+
+  __dllexport void TaskScheduler::wakeup_idle_threads_internal()
+  {
+    Lock<MutexSys> lock(idleMutex);
+    idleWakeupTime = getSeconds();
+    idleEpoch++;
+    idleCondition.notify_all();
+  }
+
   /*! run this task */
   void TaskScheduler::Task::run_internal (Thread& thread) // FIXME: avoid as many __dllexports as possible
   {
@@ -74,8 +134,11 @@ namespace embree
                [&] () { while (thread.tasks.execute_local_internal(thread,this)); });
 
     /* now signal our parent task that we are finished */
-    if (parent)
+    if (parent) {
       parent->add_dependencies(-1);
+      if (parent->dependencies == 0)
+        thread.scheduler->wakeup_idle_threads();
+    }
   }
 
     /*! run this task */
@@ -83,23 +146,72 @@ namespace embree
     run_internal(thread);
   }
 
+  __dllexport TaskScheduler::TaskQueue::TaskQueue ()
+    : left(0), right(0), stackPtr(0)
+  {
+    for (size_t i=0; i<MAX_TASK_SEGMENTS; i++) taskSegments[i] = nullptr;
+    for (size_t i=0; i<MAX_CLOSURE_SEGMENTS; i++) closureSegments[i] = nullptr;
+  }
+
+  __dllexport TaskScheduler::TaskQueue::~TaskQueue ()
+  {
+    for (size_t i=0; i<MAX_TASK_SEGMENTS; i++) alignedFree(taskSegments[i].load());
+    for (size_t i=0; i<MAX_CLOSURE_SEGMENTS; i++) alignedFree(closureSegments[i]);
+  }
+
+  __dllexport void TaskScheduler::TaskQueue::grow_tasks(size_t i)
+  {
+    const size_t s = __bsr(i/TASK_STACK_SIZE);
+    if (s >= MAX_TASK_SEGMENTS)
+      throw std::runtime_error("task stack overflow");
+
+    /* segments never get freed before the queue gets destroyed, thus stealing threads can always access them */
+    if (taskSegments[s].load() != nullptr) return;
+    const size_t N = TASK_STACK_SIZE << s;
+    Task* segment = (Task*) alignedMalloc(N*sizeof(Task),64);
+    for (size_t j=0; j<N; j++) new (&segment[j]) Task;
+    taskSegments[s] = segment;
+  }
+
+  __dllexport void* TaskScheduler::TaskQueue::alloc_segmented(size_t bytes, size_t align)
+  {
+    if (bytes+align > CLOSURE_STACK_SIZE)
+      throw std::runtime_error("closure too large for closure stack");
+
+    /* closures never cross segment boundaries, thus skip to the next segment if the closure does not fit */
+    size_t ofs = bytes + ((align - stackPtr) & (align-1));
+    if ((stackPtr % CLOSURE_STACK_SIZE) + ofs > CLOSURE_STACK_SIZE) {
+      stackPtr = (stackPtr/CLOSURE_STACK_SIZE+1)*CLOSURE_STACK_SIZE;
+      ofs = bytes + ((align - stackPtr) & (align-1));
+    }
+
+    const size_t s = stackPtr/CLOSURE_STACK_SIZE-1;
+    if (s >= MAX_CLOSURE_SEGMENTS)
+      throw std::runtime_error("closure stack overflow");
+    if (closureSegments[s] == nullptr)
+      closureSegments[s] = (char*) alignedMalloc(CLOSURE_STACK_SIZE,64);
+
+    stackPtr += ofs;
+    return &closureSegments[s][(stackPtr-bytes) % CLOSURE_STACK_SIZE];
+  }
+
   bool TaskScheduler::TaskQueue::execute_local_internal(Thread& thread, Task* parent)
   {
     /* stop if we run out of local tasks or reach the waiting task */
-    if (right == 0 || &tasks[right-1] == parent)
+    if (right == 0 || &task(right-1) == parent)
       return false;
 
     /* execute task */
     size_t oldRight = right;
-    tasks[right-1].run_internal(thread);
+    task(right-1).run_internal(thread);
     if (right != oldRight) {
       THROW_RUNTIME_ERROR("you have to wait for spawned subtasks");
     }
 
     /* pop task and closure from stack */
     right--;
-    if (tasks[right].stackPtr != size_t(-1))
-      stackPtr = tasks[right].stackPtr;
+    if (task(right).stackPtr != size_t(-1))
+      stackPtr = task(right).stackPtr;
 
     /* also move left pointer */
     if (left >= right) left.store(right.load());
@@ -119,7 +231,8 @@ namespace embree
     else
       return false;
 
-    if (!tasks[l].try_steal(thread.tasks.tasks[thread.tasks.right]))
+    thread.tasks.reserve_task(thread.tasks.right);
+    if (!task(l).try_steal(thread.tasks.task(thread.tasks.right)))
       return false;
 
     thread.tasks.right++;
@@ -130,7 +243,7 @@ namespace embree
   size_t TaskScheduler::TaskQueue::getTaskSizeAtLeft()
   {
     if (left >= right) return 0;
-    return tasks[left].N;
+    return task(left).N;
   }
 
   static MutexSys g_mutex;
@@ -143,8 +256,8 @@ namespace embree
     pool->thread_loop(threadIndex);
   }
 
-  TaskScheduler::ThreadPool::ThreadPool(bool set_affinity)
-    : numThreads(0), numThreadsRunning(0), set_affinity(set_affinity), running(false) {}
+  TaskScheduler::ThreadPool::ThreadPool(bool set_affinity, size_t affinity_offset)
+    : numThreads(0), numThreadsRunning(0), set_affinity(set_affinity), affinity_offset(affinity_offset), running(false) {}
 
   __dllexport void TaskScheduler::ThreadPool::startThreads()
   {
@@ -156,7 +269,7 @@ namespace embree
   {
     Lock<MutexSys> lock(g_mutex);
     assert(newNumThreads);
-    newNumThreads = min(newNumThreads, (size_t) getNumberOfLogicalThreads());
+    newNumThreads = (size_t) 8;
 
     numThreads = newNumThreads;
     if (!startThreads && !running) return;
@@ -173,7 +286,8 @@ namespace embree
     {
       if (t == 0) continue;
       auto pair = new std::pair<TaskScheduler::ThreadPool*,size_t>(this,t);
-      threads.push_back(createThread((thread_func)threadPoolFunction,pair,4*1024*1024,set_affinity ? t : -1));
+      const ssize_t affinity = (affinity_offset+t) % getNumberOfLogicalThreads();
+      threads.push_back(createThread((thread_func)threadPoolFunction,pair,4*1024*1024,set_affinity ? affinity : -1));
     }
 
     /* stop some threads if we reduce the number of threads */
@@ -233,10 +347,10 @@ namespace embree
     }
   }
 
-  TaskScheduler::TaskScheduler()
-    : threadCounter(0), anyTasksRunning(0), hasRootTask(false)
+  TaskScheduler::TaskScheduler(ThreadPool* pool)
+    : pool(pool), threadCounter(0), anyTasksRunning(0), hasRootTask(false), idleThreads(0), idleEpoch(0), idleWakeupTime(0.0)
   {
-    threadLocal.resize(2*getNumberOfLogicalThreads()); // FIXME: this has to be 2x as in the compatibility join mode with rtcCommitScene the worker threads also join. When disallowing rtcCommitScene to join a build we can remove the 2x.
+    threadLocal.resize(16); // FIXME: this has to be 2x as in the compatibility join mode with rtcCommitScene the worker threads also join. When disallowing rtcCommitScene to join a build we can remove the 2x.
     for (size_t i=0; i<threadLocal.size(); i++)
       threadLocal[i].store(nullptr);
   }
@@ -260,8 +374,11 @@ namespace embree
     else        return 0;
   }
 
-  __dllexport size_t TaskScheduler::threadCount() {
-    return threadPool->size();
+  __dllexport size_t TaskScheduler::threadCount()
+  {
+    Thread* thread = TaskScheduler::thread();
+    if (thread) return thread->scheduler->getThreadPool()->size();
+    else        return threadPool->size();
   }
 
   __dllexport TaskScheduler* TaskScheduler::instance()
@@ -283,6 +400,19 @@ namespace embree
     delete threadPool; threadPool = nullptr;
   }
 
+  void TaskScheduler::setIdlePolicy(IdlePolicy policy) {
+    g_idle_policy = policy;
+  }
+
+  void TaskScheduler::printIdleStatistics()
+  {
+    const size_t wakeups = g_idle_wakeups;
+    std::cout << "idle threads:" << std::endl;
+    std::cout << "  wakeups       = " << wakeups << std::endl;
+    std::cout << "  avg latency   = " << (wakeups ? 1E-3*double(g_idle_latency_sum)/double(wakeups) : 0.0) << " us" << std::endl;
+    std::cout << "  max latency   = " << 1E-3*double(g_idle_latency_max) << " us" << std::endl;
+  }
+
   __dllexport ssize_t TaskScheduler::allocThreadIndex()
   {
     size_t threadIndex = threadCounter++;
@@ -345,7 +475,7 @@ namespace embree
                  [&] () {
                    anyTasksRunning++;
                    while (thread.tasks.execute_local_internal(thread,nullptr));
-                   anyTasksRunning--;
+                   if (--anyTasksRunning == 0) wakeup_idle_threads();
                  });
     }
     threadLocal[threadIndex].store(nullptr);
@@ -379,33 +509,80 @@ namespace embree
   {
     const size_t threadIndex = thread.threadIndex;
     const size_t threadCount = this->threadCounter;
+    if (threadCount <= 1) return false;
 
-    for (size_t i=1; i<threadCount; i++)
+    /* visit victims closest first, each distance class in random order */
+    const size_t start = thread.random() % (threadCount-1);
+    for (int dist=0; dist<4; )
     {
-      __pause_cpu(32);
-      size_t otherThreadIndex = threadIndex+i;
-      if (otherThreadIndex >= threadCount) otherThreadIndex -= threadCount;
+      int nextDist = 4;
+      for (size_t i=0; i<threadCount-1; i++)
+      {
+        size_t otherThreadIndex = threadIndex+1+(start+i)%(threadCount-1);
+        if (otherThreadIndex >= threadCount) otherThreadIndex -= threadCount;
 
-      Thread* othread = threadLocal[otherThreadIndex].load();
-      if (!othread)
-        continue;
+        Thread* othread = threadLocal[otherThreadIndex].load();
+        if (!othread)
+          continue;
 
-      if (othread->tasks.steal(thread))
-        return true;
+        const int d = thread.distance(*othread);
+        if (d != dist) {
+          if (d > dist) nextDist = min(nextDist,d);
+          continue;
+        }
+
+        if (othread->tasks.steal(thread)) {
+          thread.backoff = 1;
+          return true;
+        }
+      }
+      dist = nextDist;
     }
 
+    /* exponential backoff, bounded by the spinning of one round over all threads */
+    __pause_cpu(thread.backoff);
+    thread.backoff = min(2*thread.backoff,32*(threadCount-1));
     return false;
   }
 
   __dllexport void TaskScheduler::startThreads() {
-    threadPool->startThreads();
+    getThreadPool()->startThreads();
   }
 
-  __dllexport void TaskScheduler::addScheduler(const Ref<TaskScheduler>& scheduler) {
-    threadPool->add(scheduler);
+  __dllexport void TaskScheduler::addScheduler() {
+    getThreadPool()->add(this);
   }
 
-  __dllexport void TaskScheduler::removeScheduler(const Ref<TaskScheduler>& scheduler) {
-    threadPool->remove(scheduler);
+  __dllexport void TaskScheduler::removeScheduler() {
+    getThreadPool()->remove(this);
   }
+
+  struct task_stack_regression_test : public RegressionTest
+  {
+    task_stack_regression_test(const char* name) : RegressionTest(name) {
+      registerRegressionTest(this);
+    }
+
+    bool run ()
+    {
+      /* spawns more tasks and closure data than fit into the fixed size stacks */
+      struct Payload { size_t data[32]; };
+      const size_t N = 4*TaskScheduler::TASK_STACK_SIZE;
+      std::atomic<size_t> sum(0);
+      TaskScheduler::spawn([&] ()
+      {
+        for (size_t i=0; i<N; i++)
+        {
+          Payload p;
+          for (size_t j=0; j<32; j++) p.data[j] = i;
+          TaskScheduler::spawn([&sum,p] () { sum += p.data[31]; });
+        }
+        TaskScheduler::wait();
+      });
+      TaskScheduler::wait();
+      return sum == N*(N-1)/2;
+    }
+  };
+
+  task_stack_regression_test task_stack_regression("task_stack_regression_test");
 }
@@ -24,6 +24,7 @@
 #include "../sys/condition.h"
 #include "../sys/ref.h"
 #include "../sys/atomic.h"
+#include "../sys/sysinfo.h"
 #include "../math/range.h"
 
 #include <list>
@@ -38,6 +39,14 @@ namespace embree
     static const size_t TASK_STACK_SIZE = 2*1024;           //!< task structure stack
     static const size_t CLOSURE_STACK_SIZE = 256*1024;    //!< stack for task closures
 
+    /*! how threads wait when they find no work to steal */
+    enum IdlePolicy 
+    {
+      IDLE_SPIN = 0,      //!< spin and yield until new work arrives
+      IDLE_ADAPTIVE = 1,  //!< spin and yield for some rounds, then sleep until new work arrives
+      IDLE_SLEEP = 2      //!< sleep after a single unsuccessful round of stealing
+    };
+
     struct Thread;
 
     /*! virtual interface for all tasks */
@@ -123,31 +132,54 @@ namespace embree
 
     struct TaskQueue
     {
-      TaskQueue ()
-      : left(0), right(0), stackPtr(0) {}
+      static const size_t MAX_TASK_SEGMENTS = 16;      //!< task stack grows up to TASK_STACK_SIZE << MAX_TASK_SEGMENTS tasks
+      static const size_t MAX_CLOSURE_SEGMENTS = 256;  //!< closure stack grows up to (MAX_CLOSURE_SEGMENTS+1)*CLOSURE_STACK_SIZE bytes
+
+      __dllexport TaskQueue ();
+      __dllexport ~TaskQueue ();
+
+      /*! returns the i'th task, tasks beyond the fixed size task stack are stored in segments of doubling size */
+      __forceinline Task& task(size_t i)
+      {
+        if (likely(i < TASK_STACK_SIZE)) return tasks[i];
+        const size_t s = __bsr(i/TASK_STACK_SIZE);
+        return taskSegments[s].load()[i - (TASK_STACK_SIZE << s)];
+      }
+
+      /*! makes the i'th task available, only the owning thread grows its task stack */
+      __forceinline void reserve_task(size_t i) {
+        if (unlikely(i >= TASK_STACK_SIZE)) grow_tasks(i);
+      }
+
+      __dllexport void grow_tasks(size_t i);
 
       __forceinline void* alloc(size_t bytes, size_t align = 64)
       {
         size_t ofs = bytes + ((align - stackPtr) & (align-1));
-        if (stackPtr + ofs > CLOSURE_STACK_SIZE)
-          throw std::runtime_error("closure stack overflow");
+        if (unlikely(stackPtr + ofs > CLOSURE_STACK_SIZE))
+          return alloc_segmented(bytes,align);
         stackPtr += ofs;
         return &stack[stackPtr-bytes];
       }
 
+      __dllexport void* alloc_segmented(size_t bytes, size_t align);
+
       template<typename Closure>
       __forceinline void push_right(Thread& thread, const size_t size, const Closure& closure)
       {
-        if (right >= TASK_STACK_SIZE)
-          throw std::runtime_error("task stack overflow");
+        reserve_task(right);
 
 	/* allocate new task on right side of stack */
         size_t oldStackPtr = stackPtr;
         TaskFunction* func = new (alloc(sizeof(ClosureTaskFunction<Closure>))) ClosureTaskFunction<Closure>(closure);
-        new (&tasks[right++]) Task(func,thread.task,oldStackPtr,size);
+        new (&task(right)) Task(func,thread.task,oldStackPtr,size);
+        right++;
 
 	/* also move left pointer */
 	if (left >= right-1) left = right-1;
+
+        /* let sleeping threads steal the new task */
+        thread.scheduler->wakeup_idle_threads();
       }
 
       __dllexport bool execute_local(Thread& thread, Task* parent);
@@ -161,11 +193,13 @@ namespace embree
 
       /* task stack */
       Task tasks[TASK_STACK_SIZE];
+      std::atomic<Task*> taskSegments[MAX_TASK_SEGMENTS]; //!< segment s stores tasks TASK_STACK_SIZE << s to (TASK_STACK_SIZE << (s+1))-1
       __aligned(64) std::atomic<size_t> left;   //!< threads steal from left
       __aligned(64) std::atomic<size_t> right;  //!< new tasks are added to the right
 
       /* closure stack */
       __aligned(64) char stack[CLOSURE_STACK_SIZE];
+      char* closureSegments[MAX_CLOSURE_SEGMENTS];        //!< segment s stores closures at stack locations (s+1)*CLOSURE_STACK_SIZE to (s+2)*CLOSURE_STACK_SIZE-1
       size_t stackPtr;
     };
 
@@ -175,22 +209,44 @@ namespace embree
       ALIGNED_STRUCT;
 
       Thread (size_t threadIndex, const Ref<TaskScheduler>& scheduler)
-      : threadIndex(threadIndex), task(nullptr), scheduler(scheduler) {}
+      : threadIndex(threadIndex), task(nullptr), scheduler(scheduler), 
+        topology(getCPUTopology(getCurrentCPU())), randomState(unsigned(threadIndex)+1), backoff(1) {}
 
       __forceinline size_t threadCount() {
         return scheduler->threadCounter;
       }
 
+      /*! topological distance to some other thread: 0 = same core, 1 = same core complex, 2 = same socket, 3 = different socket */
+      __forceinline int distance(const Thread& other) const 
+      {
+        if (topology.package != other.topology.package) return 3;
+        if (topology.cache   != other.topology.cache  ) return 2;
+        if (topology.core    != other.topology.core   ) return 1;
+        return 0;
+      }
+
+      /*! per thread random numbers to randomize the victim order */
+      __forceinline unsigned int random() 
+      {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return randomState;
+      }
+
       size_t threadIndex;              //!< ID of this thread
       TaskQueue tasks;                 //!< local task queue
       Task* task;                      //!< current active task
       Ref<TaskScheduler> scheduler;     //!< pointer to task scheduler
+      CPUTopology topology;            //!< topology of the CPU the thread got started on
+      unsigned int randomState;        //!< state of random number generator
+      size_t backoff;                  //!< number of pause instructions after the next failed steal round
     };
 
     /*! pool of worker threads */
     struct ThreadPool
     {
-      ThreadPool (bool set_affinity);
+      ThreadPool (bool set_affinity, size_t affinity_offset = 0);
       ~ThreadPool ();
 
       /*! starts the threads */
@@ -215,6 +271,7 @@ namespace embree
       std::atomic<size_t> numThreads;
       std::atomic<size_t> numThreadsRunning;
       bool set_affinity;
+      size_t affinity_offset;          //!< logical thread the first thread of the pool gets pinned to
       std::atomic<bool> running;
       std::vector<thread_t> threads;
 
@@ -224,7 +281,8 @@ namespace embree
       std::list<Ref<TaskScheduler> > schedulers;
     };
 
-    TaskScheduler ();
+    /*! creates a task scheduler whose worker threads come from the given thread pool, or from the global thread pool if none is specified */
+    TaskScheduler (ThreadPool* pool = nullptr);
     ~TaskScheduler ();
 
     /*! initializes the task scheduler */
@@ -233,6 +291,12 @@ namespace embree
     /*! destroys the task scheduler again */
     static void destroy();
 
+    /*! configures how threads wait when they find no work */
+    static void setIdlePolicy(IdlePolicy policy);
+
+    /*! prints number and latency of wakeups of sleeping threads */
+    static void printIdleStatistics();
+
     /*! lets new worker threads join the tasking system */
     void join();
     void reset();
@@ -252,6 +316,23 @@ namespace embree
     template<typename Predicate, typename Body>
       static void steal_loop(Thread& thread, const Predicate& pred, const Body& body);
 
+    /*! registers the calling thread as idle thread and returns the current wakeup epoch */
+    size_t idle_begin();
+
+    /*! unregisters the calling thread as idle thread without sleeping */
+    void idle_end();
+
+    /*! sleeps until some thread wakes up idle threads after the given wakeup epoch */
+    void idle_wait(size_t epoch);
+
+    /*! wakes up all sleeping threads, only called when some threads are idle */
+    __dllexport void wakeup_idle_threads_internal();
+
+    /*! wakes up sleeping threads as new work is available or some waiting condition changed */
+    __forceinline void wakeup_idle_threads() {
+      if (unlikely(idleThreads > 0)) wakeup_idle_threads_internal();
+    }
+
     /* spawn a new task at the top of the threads task stack */
     template<typename Closure>
       void spawn_root(const Closure& closure, size_t size = 1, bool useThreadPool = true)
@@ -272,11 +353,11 @@ namespace embree
         condition.notify_all();
       }
 
-      if (useThreadPool) addScheduler(this);
+      if (useThreadPool) addScheduler();
 
       while (thread.tasks.execute_local(thread,nullptr));
-      anyTasksRunning--;
-      if (useThreadPool) removeScheduler(this);
+      if (--anyTasksRunning == 0) wakeup_idle_threads();
+      if (useThreadPool) removeScheduler();
 
       threadLocal[threadIndex] = nullptr;
       swapThread(oldThread);
@@ -349,16 +430,22 @@ namespace embree
     /*! returns the taskscheduler object to be used by the master thread */
     __dllexport static TaskScheduler* instance();
 
-    /*! starts the threads */
-    __dllexport static void startThreads();
+    /*! returns the thread pool this task scheduler gets its worker threads from */
+    __forceinline ThreadPool* getThreadPool() const {
+      return pool ? pool : threadPool;
+    }
 
-    /*! adds a task scheduler object for scheduling */
-    __dllexport static void addScheduler(const Ref<TaskScheduler>& scheduler);
+    /*! starts the threads of the thread pool */
+    __dllexport void startThreads();
 
-    /*! remove the task scheduler object again */
-    __dllexport static void removeScheduler(const Ref<TaskScheduler>& scheduler);
+    /*! adds this task scheduler to the thread pool for scheduling */
+    __dllexport void addScheduler();
+
+    /*! removes this task scheduler from the thread pool again */
+    __dllexport void removeScheduler();
 
   private:
+    ThreadPool* pool;                    //!< isolated thread pool of the device, or null to use the global thread pool
     std::vector<atomic<Thread*>> threadLocal;
     std::atomic<size_t> threadCounter;
     std::atomic<size_t> anyTasksRunning;
@@ -367,8 +454,19 @@ namespace embree
     MutexSys mutex;
     ConditionSys condition;
 
+  private:
+    std::atomic<size_t> idleThreads;     //!< number of threads that are about to sleep or sleep
+    std::atomic<size_t> idleEpoch;       //!< incremented for each wakeup of idle threads
+    double idleWakeupTime;               //!< time of the last wakeup of idle threads
+    MutexSys idleMutex;
+    ConditionSys idleCondition;
+
   private:
     static size_t g_numThreads;
+    static std::atomic<int> g_idle_policy;
+    static std::atomic<size_t> g_idle_wakeups;          //!< number of times a sleeping thread got woken up
+    static std::atomic<size_t> g_idle_latency_sum;      //!< accumulated wakeup latency in nanoseconds
+    static std::atomic<size_t> g_idle_latency_max;      //!< maximal wakeup latency in nanoseconds
     static __thread TaskScheduler* g_instance;
     static __thread Thread* thread_local_thread;
     static ThreadPool* threadPool;
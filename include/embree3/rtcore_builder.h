@@ -55,8 +55,9 @@ typedef void (*RTCSplitPrimitiveFunction) (const struct RTCBuildPrimitive* primi
 /* Build flags */
 enum RTCBuildFlags
 {
-  RTC_BUILD_FLAG_NONE    = 0,
-  RTC_BUILD_FLAG_DYNAMIC = (1 << 0),
+  RTC_BUILD_FLAG_NONE       = 0,
+  RTC_BUILD_FLAG_DYNAMIC    = (1 << 0),
+  RTC_BUILD_FLAG_CLUSTERING = (1 << 1), // use agglomerative clustering for medium quality builds
 };
   
 /* Input for builders */
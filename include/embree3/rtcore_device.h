@@ -59,7 +59,9 @@ enum RTCDeviceProperty
   RTC_DEVICE_PROPERTY_USER_GEOMETRY_SUPPORTED        = 100,
 
   RTC_DEVICE_PROPERTY_TASKING_SYSTEM        = 128,
-  RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED = 129
+  RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED = 129,
+
+  RTC_DEVICE_PROPERTY_REFIT_REBUILD_COUNT = 160
 };
 
 /* Gets a device property. */
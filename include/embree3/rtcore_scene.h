@@ -36,7 +36,9 @@ enum RTCSceneFlags
   RTC_SCENE_FLAG_DYNAMIC                 = (1 << 0),
   RTC_SCENE_FLAG_COMPACT                 = (1 << 1),
   RTC_SCENE_FLAG_ROBUST                  = (1 << 2),
-  RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION = (1 << 3)
+  RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION = (1 << 3),
+  RTC_SCENE_FLAG_ASYNC_COMMIT            = (1 << 4),
+  RTC_SCENE_FLAG_PROGRESSIVE_COMMIT      = (1 << 5)
 };
 
 /* Creates a new scene. */
@@ -55,6 +57,12 @@ RTC_API unsigned int rtcAttachGeometry(RTCScene scene, RTCGeometry geometry);
 /* Attaches the geometry to a scene using the specified geometry ID. */
 RTC_API void rtcAttachGeometryByID(RTCScene scene, RTCGeometry geometry, unsigned int geomID);
 
+/* Reserves a range of consecutive geometry IDs and returns the first one. Can get called concurrently. */
+RTC_API unsigned int rtcReserveGeometryIDs(RTCScene scene, unsigned int numGeometries);
+
+/* Attaches an array of geometries to a range of reserved geometry IDs. Can get called concurrently for different ranges. */
+RTC_API void rtcAttachGeometriesByID(RTCScene scene, const RTCGeometry* geometries, unsigned int numGeometries, unsigned int firstGeomID);
+
 /* Detaches the geometry from the scene. */
 RTC_API void rtcDetachGeometry(RTCScene scene, unsigned int geomID);
 
@@ -62,12 +70,30 @@ RTC_API void rtcDetachGeometry(RTCScene scene, unsigned int geomID);
 RTC_API RTCGeometry rtcGetGeometry(RTCScene scene, unsigned int geomID);
 
 
-/* Commits the scene. */
+/* Commits the scene. Scenes with RTC_SCENE_FLAG_PROGRESSIVE_COMMIT set publish a fast preview and refine it in the background. */
 RTC_API void rtcCommitScene(RTCScene scene);
 
+/* Commits multiple scenes of the same device together. Scenes instanced by other scenes of the batch get built first, all other builds run in parallel. */
+RTC_API void rtcCommitScenes(RTCScene* scenes, size_t numScenes);
+
 /* Commits the scene from multiple threads. */
 RTC_API void rtcJoinCommitScene(RTCScene scene);
 
+/* Commit completion callback function */
+typedef void (*RTCCommitFunction)(void* ptr, RTCScene scene, bool committed);
+
+/* Commits a scene with RTC_SCENE_FLAG_ASYNC_COMMIT or RTC_SCENE_FLAG_PROGRESSIVE_COMMIT set in the background. Ray queries continue to use the previously committed version until the new version is published and the callback gets invoked. */
+RTC_API void rtcCommitSceneAsync(RTCScene scene, RTCCommitFunction func, void* ptr);
+
+/* Waits until a pending asynchronous commit or progressive refinement of the scene finished. */
+RTC_API void rtcWaitCommitScene(RTCScene scene);
+
+/* Stores the acceleration structure of a committed static scene into a file. */
+RTC_API void rtcSaveSceneBVH(RTCScene scene, const char* filename);
+
+/* Commits a static scene by loading its acceleration structure from a file written by rtcSaveSceneBVH. Returns false if the file does not match the scene. */
+RTC_API bool rtcLoadSceneBVH(RTCScene scene, const char* filename);
+
 
 /* Progress monitor callback function */
 typedef bool (*RTCProgressMonitorFunction)(void* ptr, double n);
@@ -18,11 +18,13 @@
 
 #define MBLUR_NUM_TEMPORAL_BINS 2
 #define MBLUR_NUM_OBJECT_BINS   32
+#define MBLUR_NUM_SPATIAL_BINS  16
 
 #include "../bvh/bvh.h"
 #include "../common/primref_mb.h"
 #include "heuristic_binning_array_aligned.h"
 #include "heuristic_timesplit_array.h"
+#include "heuristic_spatial_mblur_array.h"
 
 namespace embree
 {
@@ -162,7 +164,7 @@ namespace embree
         Settings ()
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(8),
           travCost(1.0f), intCost(1.0f), singleLeafTimeSegment(false),
-          singleThreadThreshold(1024) {}
+          singleThreadThreshold(1024), splitFactor(1.0f) {}
 
       public:
         size_t branchingFactor;  //!< branching factor of BVH to build
@@ -174,6 +176,7 @@ namespace embree
         float intCost;           //!< estimated cost of one primitive intersection
         bool singleLeafTimeSegment; //!< split time to single time range
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
+        float splitFactor;       //!< maximal number of primitive references relative to the number of primitives, spatial splits are enabled for values larger than 1
       };
 
       struct BuildRecord
@@ -182,10 +185,10 @@ namespace embree
 	__forceinline BuildRecord () {}
 
         __forceinline BuildRecord (size_t depth)
-          : depth(depth) {}
+          : depth(depth), clip(full) {}
 
         __forceinline BuildRecord (const SetMB& prims, size_t depth)
-          : depth(depth), prims(prims) {}
+          : depth(depth), prims(prims), clip(full) {}
 
         __forceinline friend bool operator< (const BuildRecord& a, const BuildRecord& b) {
           return a.prims.size() < b.prims.size();
@@ -198,6 +201,7 @@ namespace embree
       public:
 	size_t depth;                     //!< Depth of the root of this subtree.
 	SetMB prims;                      //!< The list of primitives.
+        BBox3fa clip;                     //!< Region of space the primitives got restricted to by spatial splits.
       };
 
       struct BuildRecordSplit : public BuildRecord
@@ -216,6 +220,7 @@ namespace embree
       template<
         typename NodeRef,
         typename RecalculatePrimRef,
+        typename SplitterFactory,
         typename Allocator,
         typename CreateAllocFunc,
         typename CreateNodeFunc,
@@ -240,6 +245,7 @@ namespace embree
 
           BuilderT (MemoryMonitorInterface* device,
                     const RecalculatePrimRef recalculatePrimRef,
+                    const SplitterFactory splitterFactory,
                     const CreateAllocFunc createAlloc,
                     const CreateNodeFunc createNode,
                     const SetNodeFunc setNode,
@@ -249,6 +255,7 @@ namespace embree
             : cfg(settings),
             heuristicObjectSplit(),
             heuristicTemporalSplit(device, recalculatePrimRef),
+            heuristicSpatialSplit(device, splitterFactory),
             recalculatePrimRef(recalculatePrimRef), createAlloc(createAlloc), createNode(createNode), setNode(setNode), createLeaf(createLeaf),
             progressMonitor(progressMonitor)
           {
@@ -257,17 +264,19 @@ namespace embree
           }
 
           /*! finds the best split */
-          const Split find(const SetMB& set)
+          const Split find(const SetMB& set, const BBox3fa& clip)
           {
             /* first try standard object split */
             const Split object_split = heuristicObjectSplit.find(set,cfg.logBlockSize);
             const float object_split_sah = object_split.splitSAH();
 
-            /* test temporal splits only when object split was bad */
+            /* test temporal and spatial splits only when object split was bad */
             const float leaf_sah = set.leafSAH(cfg.logBlockSize);
             if (object_split_sah < 0.50f*leaf_sah)
               return object_split;
 
+            Split best_split = object_split;
+
             /* do temporal splits only if the the time range is big enough */
             if (set.time_range.size() > 1.01f/float(set.max_num_time_segments))
             {
@@ -275,15 +284,26 @@ namespace embree
               const float temporal_split_sah = temporal_split.splitSAH();
 
               /* take temporal split if it improved SAH */
-              if (temporal_split_sah < object_split_sah)
-                return temporal_split;
+              if (temporal_split_sah < best_split.splitSAH())
+                best_split = temporal_split;
+            }
+
+            /* do spatial splits only if enabled */
+            if (cfg.splitFactor > 1.0f)
+            {
+              const Split spatial_split = heuristicSpatialSplit.find(set,clip,cfg.logBlockSize);
+              const float spatial_split_sah = spatial_split.splitSAH();
+
+              /* take spatial split if it improved SAH */
+              if (spatial_split_sah < best_split.splitSAH())
+                best_split = spatial_split;
             }
 
-            return object_split;
+            return best_split;
           }
 
           /*! array partitioning */
-          __forceinline std::unique_ptr<mvector<PrimRefMB>> split(const Split& split, const SetMB& set, SetMB& lset, SetMB& rset)
+          __forceinline std::unique_ptr<mvector<PrimRefMB>> split(const Split& split, const SetMB& set, const BBox3fa& clip, SetMB& lset, SetMB& rset)
           {
             /* perform object split */
             if (likely(split.data == Split::SPLIT_OBJECT)) {
@@ -293,6 +313,10 @@ namespace embree
             else if (likely(split.data == Split::SPLIT_TEMPORAL)) {
               return heuristicTemporalSplit.split(split,set,lset,rset);
             }
+            /* perform spatial split */
+            else if (unlikely(split.data == Split::SPLIT_SPATIAL)) {
+              return heuristicSpatialSplit.split(split,set,clip,lset,rset);
+            }
             /* perform fallback split */
             else if (unlikely(split.data == Split::SPLIT_FALLBACK)) {
               set.deterministic_order();
@@ -304,6 +328,26 @@ namespace embree
             return std::unique_ptr<mvector<PrimRefMB>>();
           }
 
+          /*! restricts the children of a spatial split to both sides of the split plane */
+          __forceinline void clipChildren(const Split& split, const BuildRecord& brecord, BuildRecord& lrecord, BuildRecord& rrecord)
+          {
+            lrecord.clip = rrecord.clip = brecord.clip;
+            if (split.data == Split::SPLIT_SPATIAL) {
+              lrecord.clip.upper[split.dim] = split.fpos;
+              rrecord.clip.lower[split.dim] = split.fpos;
+            }
+          }
+
+          /*! calculates linear bounds of the primitives of a build record */
+          __forceinline LBBox3fa linearBounds(const BuildRecord& current)
+          {
+            /* spatial splits require clipping the primitives to the region of the build record */
+            if (cfg.splitFactor > 1.0f)
+              return heuristicSpatialSplit.linearBounds(current.prims,current.clip);
+            else
+              return current.prims.linearBounds(recalculatePrimRef);
+          }
+
           /*! finds the best fallback split */
           __noinline Split findFallback(const SetMB& set)
           {
@@ -357,11 +401,15 @@ namespace embree
               throw_RTCError(RTC_ERROR_UNKNOWN,"depth limit reached");
 
             /* replace already found split by fallback split */
-            const BuildRecordSplit current(BuildRecord(in.prims,in.depth),findFallback(in.prims));
+            const BuildRecordSplit current(in,findFallback(in.prims));
 
             /* create leaf for few primitives */
             if (current.size() <= cfg.maxLeafSize && current.split.data != Split::SPLIT_TEMPORAL)
-              return createLeaf(current,alloc);
+            {
+              NodeRecordMB4D leaf = createLeaf(current,alloc);
+              if (cfg.splitFactor > 1.0f) leaf.lbounds = linearBounds(current);
+              return leaf;
+            }
 
             /* fill all children by always splitting the largest one */
             bool hasTimeSplits = false;
@@ -390,8 +438,9 @@ namespace embree
               BuildRecordSplit& brecord = children[bestChild];
               BuildRecordSplit lrecord(current.depth+1);
               BuildRecordSplit rrecord(current.depth+1);
-              std::unique_ptr<mvector<PrimRefMB>> new_vector = split(brecord.split,brecord.prims,lrecord.prims,rrecord.prims);
-              hasTimeSplits |= new_vector != nullptr;
+              std::unique_ptr<mvector<PrimRefMB>> new_vector = split(brecord.split,brecord.prims,brecord.clip,lrecord.prims,rrecord.prims);
+              hasTimeSplits |= brecord.split.data == Split::SPLIT_TEMPORAL;
+              clipChildren(brecord.split,brecord,lrecord,rrecord);
 
               /* find new splits */
               lrecord.split = findFallback(lrecord.prims);
@@ -413,7 +462,7 @@ namespace embree
 
             /* calculate geometry bounds of this node */
             if (hasTimeSplits)
-              return NodeRecordMB4D(node,current.prims.linearBounds(recalculatePrimRef),current.prims.time_range);
+              return NodeRecordMB4D(node,linearBounds(current),current.prims.time_range);
             else
               return NodeRecordMB4D(node,gbounds,current.prims.time_range);
           }
@@ -429,7 +478,7 @@ namespace embree
               progressMonitor(current.size());
 
             /*! find best split */
-            const Split csplit = find(current.prims);
+            const Split csplit = find(current.prims,current.clip);
 
             /*! compute leaf and split cost */
             const float leafSAH  = cfg.intCost*current.prims.leafSAH(cfg.logBlockSize);
@@ -444,13 +493,14 @@ namespace embree
 
             /*! perform initial split */
             SetMB lprims,rprims;
-            std::unique_ptr<mvector<PrimRefMB>> new_vector = split(csplit,current.prims,lprims,rprims);
-            bool hasTimeSplits = new_vector != nullptr;
+            std::unique_ptr<mvector<PrimRefMB>> new_vector = split(csplit,current.prims,current.clip,lprims,rprims);
+            bool hasTimeSplits = csplit.data == Split::SPLIT_TEMPORAL;
             NodeRecordMB4D values[MAX_BRANCHING_FACTOR];
             LocalChildList children(current);
             {
               BuildRecord lrecord(lprims,current.depth+1);
               BuildRecord rrecord(rprims,current.depth+1);
+              clipChildren(csplit,current,lrecord,rrecord);
               children.split(0,lrecord,rrecord,std::move(new_vector));
             }
 
@@ -473,9 +523,10 @@ namespace embree
               BuildRecord& brecord = children[bestChild];
               BuildRecord lrecord(current.depth+1);
               BuildRecord rrecord(current.depth+1);
-              Split csplit = find(brecord.prims);
-              std::unique_ptr<mvector<PrimRefMB>> new_vector = split(csplit,brecord.prims,lrecord.prims,rrecord.prims);
-              hasTimeSplits |= new_vector != nullptr;
+              Split csplit = find(brecord.prims,brecord.clip);
+              std::unique_ptr<mvector<PrimRefMB>> new_vector = split(csplit,brecord.prims,brecord.clip,lrecord.prims,rrecord.prims);
+              hasTimeSplits |= csplit.data == Split::SPLIT_TEMPORAL;
+              clipChildren(csplit,brecord,lrecord,rrecord);
               children.split(bestChild,lrecord,rrecord,std::move(new_vector));
             }
 
@@ -515,7 +566,7 @@ namespace embree
 
             /* calculate geometry bounds of this node */
             if (unlikely(hasTimeSplits))
-              return NodeRecordMB4D(node,current.prims.linearBounds(recalculatePrimRef),current.prims.time_range);
+              return NodeRecordMB4D(node,linearBounds(current),current.prims.time_range);
             else
               return NodeRecordMB4D(node,gbounds,current.prims.time_range);
           }
@@ -524,6 +575,7 @@ namespace embree
           __forceinline const NodeRecordMB4D operator() (mvector<PrimRefMB>& prims, const PrimInfoMB& pinfo)
           {
             const SetMB set(pinfo,&prims);
+            heuristicSpatialSplit.init(pinfo.size(),cfg.splitFactor);
             auto ret = recurse(BuildRecord(set,1),nullptr,true);
             _mm_mfence(); // to allow non-temporal stores during build
             return ret;
@@ -533,6 +585,7 @@ namespace embree
           Settings cfg;
           HeuristicArrayBinningMB<PrimRefMB,MBLUR_NUM_OBJECT_BINS> heuristicObjectSplit;
           HeuristicMBlurTemporalSplit<PrimRefMB,RecalculatePrimRef,MBLUR_NUM_TEMPORAL_BINS> heuristicTemporalSplit;
+          HeuristicMBlurSpatialSplit<SplitterFactory,MBLUR_NUM_SPATIAL_BINS> heuristicSpatialSplit;
           const RecalculatePrimRef recalculatePrimRef;
           const CreateAllocFunc createAlloc;
           const CreateNodeFunc createNode;
@@ -543,6 +596,7 @@ namespace embree
 
       template<typename NodeRef,
         typename RecalculatePrimRef,
+        typename SplitterFactory,
         typename CreateAllocFunc,
         typename CreateNodeFunc,
         typename SetNodeFunc,
@@ -553,6 +607,7 @@ namespace embree
                                                       const PrimInfoMB& pinfo,
                                                       MemoryMonitorInterface* device,
                                                       const RecalculatePrimRef recalculatePrimRef,
+                                                      const SplitterFactory splitterFactory,
                                                       const CreateAllocFunc createAlloc,
                                                       const CreateNodeFunc createNode,
                                                       const SetNodeFunc setNode,
@@ -563,6 +618,7 @@ namespace embree
           typedef BuilderT<
             NodeRef,
             RecalculatePrimRef,
+            SplitterFactory,
             decltype(createAlloc()),
             CreateAllocFunc,
             CreateNodeFunc,
@@ -572,6 +628,7 @@ namespace embree
 
           Builder builder(device,
                           recalculatePrimRef,
+                          splitterFactory,
                           createAlloc,
                           createNode,
                           setNode,
@@ -582,6 +639,29 @@ namespace embree
 
           return builder(prims,pinfo);
         }
+
+      template<typename NodeRef,
+        typename RecalculatePrimRef,
+        typename CreateAllocFunc,
+        typename CreateNodeFunc,
+        typename SetNodeFunc,
+        typename CreateLeafFunc,
+        typename ProgressMonitorFunc>
+
+        static const BVHNodeRecordMB4D<NodeRef> build(mvector<PrimRefMB>& prims,
+                                                      const PrimInfoMB& pinfo,
+                                                      MemoryMonitorInterface* device,
+                                                      const RecalculatePrimRef recalculatePrimRef,
+                                                      const CreateAllocFunc createAlloc,
+                                                      const CreateNodeFunc createNode,
+                                                      const SetNodeFunc setNode,
+                                                      const CreateLeafFunc createLeaf,
+                                                      const ProgressMonitorFunc progressMonitor,
+                                                      const Settings& settings)
+      {
+        return build<NodeRef>(prims,pinfo,device,recalculatePrimRef,LinearBoundsSplitterMBFactory<RecalculatePrimRef>(recalculatePrimRef),
+                              createAlloc,createNode,setNode,createLeaf,progressMonitor,settings);
+      }
     };
   }
 }
@@ -0,0 +1,533 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh_builder_morton.h"
+#include "../../common/algorithms/parallel_prefix_sum.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Parallel locally-ordered clustering (PLOC) builder. Primitives
+     *  get sorted by morton code and each cluster is merged with its
+     *  nearest neighbor inside a small search window, until a single
+     *  cluster is left. The resulting binary tree is collapsed into a
+     *  BVH of the requested branching factor. */
+    struct BVHBuilderPLOC
+    {
+      static const size_t MAX_BRANCHING_FACTOR = 8;          //!< maximum supported BVH branching factor
+      static const size_t MIN_LARGE_LEAF_LEVELS = 8;         //!< create balanced tree of we are that many levels before the maximum tree depth
+
+      typedef BVHBuilderMorton::BuildPrim BuildPrim;
+
+      /*! settings for PLOC builder */
+      struct Settings
+      {
+        /*! default settings */
+        Settings ()
+        : branchingFactor(2), maxDepth(32), minLeafSize(1), maxLeafSize(8), travCost(1.0f), intCost(1.0f), searchRadius(16), singleThreadThreshold(1024) {}
+
+        /*! initialize settings from API settings */
+        Settings (const RTCBuildArguments& settings)
+        : branchingFactor(2), maxDepth(32), minLeafSize(1), maxLeafSize(8), travCost(1.0f), intCost(1.0f), searchRadius(16), singleThreadThreshold(1024)
+        {
+          if (RTC_BUILD_ARGUMENTS_HAS(settings,maxBranchingFactor)) branchingFactor = settings.maxBranchingFactor;
+          if (RTC_BUILD_ARGUMENTS_HAS(settings,maxDepth          )) maxDepth        = settings.maxDepth;
+          if (RTC_BUILD_ARGUMENTS_HAS(settings,minLeafSize       )) minLeafSize     = settings.minLeafSize;
+          if (RTC_BUILD_ARGUMENTS_HAS(settings,maxLeafSize       )) maxLeafSize     = settings.maxLeafSize;
+          if (RTC_BUILD_ARGUMENTS_HAS(settings,traversalCost     )) travCost        = settings.traversalCost;
+          if (RTC_BUILD_ARGUMENTS_HAS(settings,intersectionCost  )) intCost         = settings.intersectionCost;
+        }
+
+        /*! initialize settings from morton builder settings */
+        Settings (const BVHBuilderMorton::Settings& settings)
+        : branchingFactor(settings.branchingFactor), maxDepth(settings.maxDepth), minLeafSize(settings.minLeafSize), maxLeafSize(settings.maxLeafSize),
+          travCost(1.0f), intCost(1.0f), searchRadius(16), singleThreadThreshold(settings.singleThreadThreshold) {}
+
+      public:
+        size_t branchingFactor;  //!< branching factor of BVH to build
+        size_t maxDepth;         //!< maximum depth of BVH to build
+        size_t minLeafSize;      //!< minimum size of a leaf
+        size_t maxLeafSize;      //!< maximum size of a leaf
+        float travCost;          //!< estimated cost of one traversal step
+        float intCost;           //!< estimated cost of one primitive intersection
+        size_t searchRadius;     //!< number of clusters to the left and right to search for the nearest neighbor
+        size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
+      };
+
+      /*! node of the binary cluster tree */
+      struct __aligned(16) ClusterNode
+      {
+        static const unsigned INVALID = unsigned(-1);
+
+        BBox3fa bounds;   //!< bounds of all primitives of the cluster
+        unsigned left;    //!< left child, or primitive for single primitive clusters
+        unsigned right;   //!< right child, INVALID for single primitive clusters
+        unsigned size;    //!< number of primitives of the cluster
+        float cost;       //!< SAH cost of the cluster subtree
+
+        __forceinline bool isPrimitive() const { return right == INVALID; }
+      };
+
+      /*! number of clusters and merges of some range of clusters */
+      struct ClusterCount
+      {
+        __forceinline ClusterCount () {}
+        __forceinline ClusterCount (size_t clusters, size_t merges) : clusters(clusters), merges(merges) {}
+        __forceinline friend ClusterCount operator+ (const ClusterCount& a, const ClusterCount& b) {
+          return ClusterCount(a.clusters+b.clusters,a.merges+b.merges);
+        }
+        size_t clusters;
+        size_t merges;
+      };
+
+      template<
+        typename ReductionTy,
+        typename Allocator,
+        typename CreateAllocator,
+        typename CreateNodeFunc,
+        typename SetNodeBoundsFunc,
+        typename CreateLeafFunc,
+        typename CalculateBounds,
+        typename ProgressMonitor>
+
+        class BuilderT : private Settings
+      {
+        ALIGNED_CLASS;
+
+      public:
+
+        BuilderT (CreateAllocator& createAllocator,
+                  CreateNodeFunc& createNode,
+                  SetNodeBoundsFunc& setBounds,
+                  CreateLeafFunc& createLeaf,
+                  CalculateBounds& calculateBounds,
+                  ProgressMonitor& progressMonitor,
+                  const Settings& settings)
+
+          : Settings(settings),
+          createAllocator(createAllocator),
+          createNode(createNode),
+          setBounds(setBounds),
+          createLeaf(createLeaf),
+          calculateBounds(calculateBounds),
+          progressMonitor(progressMonitor),
+          morton(nullptr) {}
+
+        /*! SAH cost of a leaf containing all primitives of some cluster */
+        __forceinline float leafCost(const ClusterNode& node) const {
+          return intCost*halfArea(node.bounds)*float(node.size);
+        }
+
+        /*! clusters get turned into a leaf if this is cheaper than splitting them */
+        __forceinline bool isLeaf(const ClusterNode& node) const {
+          return node.size <= minLeafSize || (node.size <= maxLeafSize && leafCost(node) <= node.cost);
+        }
+
+        __forceinline void initPrimitive(unsigned nodeID, const BBox3fa& bounds)
+        {
+          ClusterNode& node = nodes[nodeID];
+          node.bounds = bounds;
+          node.left = nodeID;
+          node.right = ClusterNode::INVALID;
+          node.size = 1;
+          node.cost = leafCost(node);
+        }
+
+        __forceinline void mergeClusters(unsigned nodeID, unsigned left, unsigned right)
+        {
+          ClusterNode& node = nodes[nodeID];
+          node.bounds = merge(nodes[left].bounds,nodes[right].bounds);
+          node.left = left;
+          node.right = right;
+          node.size = nodes[left].size + nodes[right].size;
+          node.cost = travCost*halfArea(node.bounds) + nodes[left].cost + nodes[right].cost;
+          if (node.size <= maxLeafSize) node.cost = min(node.cost,leafCost(node));
+        }
+
+        /*! finds the cluster inside the search window whose merged bounds have smallest surface area */
+        __forceinline unsigned findNearestNeighbor(size_t i, size_t numClusters) const
+        {
+          const size_t begin = i > searchRadius ? i-searchRadius : 0;
+          const size_t end   = min(i+searchRadius+1,numClusters);
+
+          /* ties are resolved by cluster index to guarantee that mutual nearest neighbors exist */
+          float bestArea = pos_inf;
+          size_t bestIndex = i == 0 ? 1 : 0;
+          for (size_t j=begin; j<end; j++)
+          {
+            if (j == i) continue;
+            const float area = halfArea(merge(clusterBounds[i],clusterBounds[j]));
+            const size_t lo = min(i,j), hi = max(i,j);
+            const size_t bestLo = min(i,bestIndex), bestHi = max(i,bestIndex);
+            if (area < bestArea || (area == bestArea && (lo < bestLo || (lo == bestLo && hi < bestHi)))) {
+              bestArea = area;
+              bestIndex = j;
+            }
+          }
+          return (unsigned) bestIndex;
+        }
+
+        /*! merges all pairs of mutual nearest neighbors and compacts the cluster array */
+        __forceinline ClusterCount mergeNeighbors(const range<size_t>& r, const ClusterCount& base, unsigned firstNodeID, bool write)
+        {
+          ClusterCount count(0,0);
+          for (size_t i=r.begin(); i<r.end(); i++)
+          {
+            const unsigned j = neighbors[i];
+            const bool mutual = neighbors[j] == i;
+
+            /* the cluster with smaller index performs the merge */
+            if (mutual && j < i) continue;
+
+            if (write)
+            {
+              const size_t pos = base.clusters + count.clusters;
+              if (mutual) {
+                const unsigned nodeID = firstNodeID + unsigned(base.merges + count.merges);
+                mergeClusters(nodeID,clusters[i],clusters[j]);
+                nextClusters[pos] = nodeID;
+                nextClusterBounds[pos] = nodes[nodeID].bounds;
+              } else {
+                nextClusters[pos] = clusters[i];
+                nextClusterBounds[pos] = clusterBounds[i];
+              }
+            }
+            count.clusters++;
+            count.merges += mutual;
+          }
+          return count;
+        }
+
+        /*! builds the binary cluster tree and returns its root */
+        unsigned buildClusterTree(size_t numPrimitives)
+        {
+          prims.resize(numPrimitives);
+          nodes.resize(2*numPrimitives-1);
+          clusters.resize(numPrimitives);
+          clusterBounds.resize(numPrimitives);
+          nextClusters.resize(numPrimitives);
+          nextClusterBounds.resize(numPrimitives);
+          neighbors.resize(numPrimitives);
+
+          /* every primitive starts as its own cluster */
+          parallel_for(size_t(0), numPrimitives, size_t(1024), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                prims[i] = morton[i];
+                initPrimitive((unsigned)i,calculateBounds(morton[i]));
+                clusters[i] = (unsigned) i;
+                clusterBounds[i] = nodes[i].bounds;
+              }
+            });
+
+          size_t numClusters = numPrimitives;
+          unsigned nextNodeID = (unsigned) numPrimitives;
+          while (numClusters > 1)
+          {
+            /* find nearest neighbor of each cluster */
+            parallel_for(size_t(0), numClusters, size_t(1024), [&] (const range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++)
+                  neighbors[i] = findNearestNeighbor(i,numClusters);
+              });
+
+            /* merge mutual nearest neighbors, the first pass only counts */
+            ClusterCount count(0,0);
+            if (numClusters < singleThreadThreshold)
+              count = mergeNeighbors(range<size_t>(0,numClusters),ClusterCount(0,0),nextNodeID,true);
+            else
+            {
+              ParallelPrefixSumState<ClusterCount> state;
+              parallel_prefix_sum(state, size_t(0), numClusters, size_t(1024), ClusterCount(0,0), [&] (const range<size_t>& r, const ClusterCount& base) {
+                  return mergeNeighbors(r,base,nextNodeID,false);
+                }, std::plus<ClusterCount>());
+              count = parallel_prefix_sum(state, size_t(0), numClusters, size_t(1024), ClusterCount(0,0), [&] (const range<size_t>& r, const ClusterCount& base) {
+                  return mergeNeighbors(r,base,nextNodeID,true);
+                }, std::plus<ClusterCount>());
+            }
+
+            /* this only happens for invalid bounds, thus merge the first two clusters to guarantee progress */
+            if (unlikely(count.merges == 0))
+            {
+              mergeClusters(nextNodeID,nextClusters[0],nextClusters[1]);
+              nextClusters[0] = nextNodeID;
+              nextClusterBounds[0] = nodes[nextNodeID].bounds;
+              for (size_t i=2; i<count.clusters; i++) {
+                nextClusters[i-1] = nextClusters[i];
+                nextClusterBounds[i-1] = nextClusterBounds[i];
+              }
+              count.clusters--;
+              count.merges++;
+            }
+
+            nextNodeID += (unsigned) count.merges;
+            numClusters = count.clusters;
+            std::swap(clusters,nextClusters);
+            std::swap(clusterBounds,nextClusterBounds);
+            progressMonitor(count.merges);
+          }
+          progressMonitor(1);
+
+          assert(nextNodeID == 2*numPrimitives-1);
+          return clusters[0];
+        }
+
+        /*! copies the primitives of some cluster in tree order to the morton array */
+        void gatherPrimitives(unsigned nodeID, unsigned begin)
+        {
+          /* the stack never holds more entries than the cluster has primitives */
+          unsigned static_stack[64];
+          std::vector<unsigned> dynamic_stack;
+          unsigned* stack = static_stack;
+          if (nodes[nodeID].size > 64) {
+            dynamic_stack.resize(nodes[nodeID].size);
+            stack = dynamic_stack.data();
+          }
+
+          size_t stackSize = 0;
+          stack[stackSize++] = nodeID;
+          while (stackSize)
+          {
+            const ClusterNode& node = nodes[stack[--stackSize]];
+            if (node.isPrimitive()) {
+              morton[begin++] = prims[node.left];
+              continue;
+            }
+            stack[stackSize++] = node.right;
+            stack[stackSize++] = node.left;
+          }
+        }
+
+        ReductionTy createLargeLeaf(size_t depth, const range<unsigned>& current, Allocator alloc)
+        {
+          /* this should never occur but is a fatal error */
+          if (depth > maxDepth)
+            throw_RTCError(RTC_ERROR_UNKNOWN,"depth limit reached");
+
+          /* create leaf for few primitives */
+          if (current.size() <= maxLeafSize)
+            return createLeaf(current,alloc);
+
+          /* fill all children by always splitting the largest one */
+          range<unsigned> children[MAX_BRANCHING_FACTOR];
+          size_t numChildren = 1;
+          children[0] = current;
+
+          do {
+
+            /* find best child with largest number of primitives */
+            size_t bestChild = -1;
+            size_t bestSize = 0;
+            for (size_t i=0; i<numChildren; i++)
+            {
+              /* ignore leaves as they cannot get split */
+              if (children[i].size() <= maxLeafSize)
+                continue;
+
+              /* remember child with largest size */
+              if (children[i].size() > bestSize) {
+                bestSize = children[i].size();
+                bestChild = i;
+              }
+            }
+            if (bestChild == size_t(-1)) break;
+
+            /*! split best child into left and right child */
+            auto split = children[bestChild].split();
+
+            /* add new children left and right */
+            children[bestChild] = children[numChildren-1];
+            children[numChildren-1] = split.first;
+            children[numChildren+0] = split.second;
+            numChildren++;
+
+          } while (numChildren < branchingFactor);
+
+          /* create node */
+          auto node = createNode(alloc,numChildren);
+
+          /* recurse into each child */
+          ReductionTy bounds[MAX_BRANCHING_FACTOR];
+          for (size_t i=0; i<numChildren; i++)
+            bounds[i] = createLargeLeaf(depth+1,children[i],alloc);
+
+          return setBounds(node,bounds,numChildren);
+        }
+
+        /*! collapses the binary cluster tree into a BVH of the requested branching factor */
+        ReductionTy recurse(size_t depth, unsigned nodeID, unsigned begin, Allocator alloc)
+        {
+          /* get thread local allocator */
+          if (!alloc)
+            alloc = createAllocator();
+
+          const ClusterNode& cluster = nodes[nodeID];
+          const range<unsigned> current(begin,begin+cluster.size);
+
+          /* create leaf node */
+          if (unlikely(depth+MIN_LARGE_LEAF_LEVELS >= maxDepth || isLeaf(cluster))) {
+            gatherPrimitives(nodeID,begin);
+            return createLargeLeaf(depth,current,alloc);
+          }
+
+          /* fill all children by always opening the one with the largest surface area */
+          unsigned children[MAX_BRANCHING_FACTOR];
+          children[0] = cluster.left;
+          children[1] = cluster.right;
+          size_t numChildren = 2;
+
+          while (numChildren < branchingFactor)
+          {
+            int bestChild = -1;
+            float bestArea = neg_inf;
+            for (size_t i=0; i<numChildren; i++)
+            {
+              /* ignore leaves as they cannot get opened */
+              const ClusterNode& child = nodes[children[i]];
+              if (isLeaf(child))
+                continue;
+
+              /* remember child with largest area */
+              if (halfArea(child.bounds) > bestArea) {
+                bestArea = halfArea(child.bounds);
+                bestChild = (int) i;
+              }
+            }
+            if (bestChild == -1) break;
+
+            /* replace best child by its two children */
+            const ClusterNode& child = nodes[children[bestChild]];
+            children[bestChild] = child.left;
+            children[numChildren++] = child.right;
+          }
+
+          /* calculate primitive ranges of children */
+          unsigned childBegin[MAX_BRANCHING_FACTOR];
+          for (size_t i=0; i<numChildren; i++) {
+            childBegin[i] = begin;
+            begin += nodes[children[i]].size;
+          }
+
+          /* allocate node */
+          auto node = createNode(alloc,numChildren);
+
+          /* process top parts of tree parallel */
+          ReductionTy bounds[MAX_BRANCHING_FACTOR];
+          if (current.size() > singleThreadThreshold)
+          {
+            /*! parallel_for is faster than spawing sub-tasks */
+            parallel_for(size_t(0), numChildren, [&] (const range<size_t>& r) {
+                for (size_t i=r.begin(); i<r.end(); i++) {
+                  bounds[i] = recurse(depth+1,children[i],childBegin[i],nullptr);
+                  _mm_mfence(); // to allow non-temporal stores during build
+                }
+              });
+          }
+
+          /* finish tree sequentially */
+          else
+          {
+            for (size_t i=0; i<numChildren; i++)
+              bounds[i] = recurse(depth+1,children[i],childBegin[i],alloc);
+          }
+
+          return setBounds(node,bounds,numChildren);
+        }
+
+        /* build function */
+        ReductionTy build(BuildPrim* src, BuildPrim* tmp, size_t numPrimitives)
+        {
+          /* sort morton codes */
+          morton = src;
+          radix_sort_u32(src,tmp,numPrimitives,singleThreadThreshold);
+
+          /* empty builds produce an empty leaf */
+          if (numPrimitives == 0)
+            return createLargeLeaf(1,range<unsigned>(0,0),createAllocator());
+
+          /* cluster primitives */
+          const unsigned root = buildClusterTree(numPrimitives);
+
+          /* build BVH */
+          const ReductionTy bvh = recurse(1,root,0,nullptr);
+          _mm_mfence(); // to allow non-temporal stores during build
+          return bvh;
+        }
+
+      public:
+        CreateAllocator& createAllocator;
+        CreateNodeFunc& createNode;
+        SetNodeBoundsFunc& setBounds;
+        CreateLeafFunc& createLeaf;
+        CalculateBounds& calculateBounds;
+        ProgressMonitor& progressMonitor;
+
+      public:
+        BuildPrim* morton;
+        avector<BuildPrim> prims; //!< sorted primitives, the morton array gets reordered while collapsing the tree
+        avector<ClusterNode> nodes;
+        avector<unsigned> clusters;
+        avector<BBox3fa> clusterBounds;
+        avector<unsigned> nextClusters;
+        avector<BBox3fa> nextClusterBounds;
+        avector<unsigned> neighbors;
+      };
+
+
+      template<
+      typename ReductionTy,
+        typename CreateAllocFunc,
+        typename CreateNodeFunc,
+        typename SetBoundsFunc,
+        typename CreateLeafFunc,
+        typename CalculateBoundsFunc,
+        typename ProgressMonitor>
+
+        static ReductionTy build(CreateAllocFunc createAllocator,
+                                 CreateNodeFunc createNode,
+                                 SetBoundsFunc setBounds,
+                                 CreateLeafFunc createLeaf,
+                                 CalculateBoundsFunc calculateBounds,
+                                 ProgressMonitor progressMonitor,
+                                 BuildPrim* src,
+                                 BuildPrim* tmp,
+                                 size_t numPrimitives,
+                                 const Settings& settings)
+        {
+          typedef BuilderT<
+            ReductionTy,
+            decltype(createAllocator()),
+            CreateAllocFunc,
+            CreateNodeFunc,
+            SetBoundsFunc,
+            CreateLeafFunc,
+            CalculateBoundsFunc,
+            ProgressMonitor> Builder;
+
+          Builder builder(createAllocator,
+                          createNode,
+                          setBounds,
+                          createLeaf,
+                          calculateBounds,
+                          progressMonitor,
+                          settings);
+
+          return builder.build(src,tmp,numPrimitives);
+        }
+    };
+  }
+}
@@ -135,6 +135,7 @@ namespace embree
           SPLIT_OBJECT   = 0,
           SPLIT_TEMPORAL = 1,
           SPLIT_FALLBACK = 2,
+          SPLIT_SPATIAL  = 3,
         };
 
         /*! construct an invalid split by default */
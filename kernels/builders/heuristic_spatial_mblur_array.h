@@ -0,0 +1,381 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "heuristic_spatial.h"
+#include "splitter.h"
+
+#define MBLUR_SPATIAL_SPLIT_THRESHOLD 1.05f
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Splits any motion blurred primitive by only clipping its linear bounds. */
+    template<typename RecalculatePrimRef>
+      struct LinearBoundsSplitterMB
+      {
+        __forceinline LinearBoundsSplitterMB(const RecalculatePrimRef& recalculatePrimRef, const PrimRefMB& prim, const BBox1f& time_range)
+          : lbounds(recalculatePrimRef.linearBounds(prim,time_range)) {}
+
+        __forceinline BBox3fa bounds(const BBox3fa& clip) const {
+          return intersect(lbounds.bounds(),clip);
+        }
+
+        __forceinline LBBox3fa linearBounds(const BBox3fa& cbounds) const {
+          return clipLinearBounds(lbounds,cbounds);
+        }
+
+      private:
+        LBBox3fa lbounds;
+      };
+
+    template<typename RecalculatePrimRef>
+      struct LinearBoundsSplitterMBFactory
+      {
+        __forceinline LinearBoundsSplitterMBFactory(const RecalculatePrimRef& recalculatePrimRef)
+          : recalculatePrimRef(recalculatePrimRef) {}
+
+        __forceinline LinearBoundsSplitterMBFactory(Scene* scene)
+          : recalculatePrimRef(scene) {}
+
+        __forceinline LinearBoundsSplitterMB<RecalculatePrimRef> operator() (const PrimRefMB& prim, const BBox1f& time_range) const {
+          return LinearBoundsSplitterMB<RecalculatePrimRef>(recalculatePrimRef,prim,time_range);
+        }
+
+      private:
+        const RecalculatePrimRef recalculatePrimRef;
+      };
+
+    /*! Performs spatial split binning of motion blurred primitives. The
+     *  primitives of a set are clipped against the region of space the
+     *  set got restricted to by spatial splits further up the tree. */
+    template<typename SplitterFactory, size_t BINS>
+      struct HeuristicMBlurSpatialSplit
+      {
+        typedef BinSplit<MBLUR_NUM_OBJECT_BINS> Split;
+        typedef typename PrimRefMB::BBox BBox;
+
+        static const size_t PARALLEL_THRESHOLD = 3 * 1024;
+        static const size_t PARALLEL_FIND_BLOCK_SIZE = 1024;
+        static const size_t PARALLEL_PARTITION_BLOCK_SIZE = 128;
+
+        HeuristicMBlurSpatialSplit (MemoryMonitorInterface* device, const SplitterFactory& splitterFactory)
+          : device(device), splitterFactory(splitterFactory), maxReplications(0), numReplications(0) {}
+
+        /*! returns bounds of linear bounds as used for binning */
+        static __forceinline BBox binBounds(const LBBox3fa& lbounds)
+        {
+#if MBLUR_BIN_LBBOX
+          return lbounds;
+#else
+          return lbounds.interpolate(0.5f);
+#endif
+        }
+
+        struct SpatialBinInfo
+        {
+          __forceinline SpatialBinInfo () {
+          }
+
+          __forceinline SpatialBinInfo (EmptyTy)
+          {
+            for (size_t i=0; i<BINS; i++)
+            {
+              for (size_t dim=0; dim<3; dim++)
+              {
+                bounds[i][dim] = empty;
+                numBegin[i][dim] = numEnd[i][dim] = 0;
+                primsBegin[i][dim] = primsEnd[i][dim] = 0;
+              }
+            }
+          }
+
+          void bin(const SplitterFactory& splitterFactory, const PrimRefMB* prims, size_t begin, size_t end, const BBox1f& time_range, const BBox3fa& clip, const SpatialBinMapping<BINS>& mapping)
+          {
+            for (size_t i=begin; i<end; i++)
+            {
+              const PrimRefMB& prim = prims[i];
+              const auto splitter = splitterFactory(prim,time_range);
+              const BBox3fa pbounds = splitter.bounds(clip);
+              if (pbounds.empty()) continue;
+              const std::pair<vint4,vint4> bins = mapping.bin(pbounds);
+
+              for (size_t dim=0; dim<3; dim++)
+              {
+                if (unlikely(mapping.invalid(dim)))
+                  continue;
+
+                /* make bins consistent with the classification of the split function */
+                const float lower = pbounds.lower[dim], upper = pbounds.upper[dim];
+                auto isLeft  = [&] (size_t b) { return lower < mapping.pos(b,dim) || upper <= mapping.pos(b,dim); };
+                auto isRight = [&] (size_t b) { return upper > mapping.pos(b,dim); };
+                size_t bin0 = bins.first[dim];
+                while (bin0 > 0 && isLeft(bin0)) bin0--;
+                while (bin0+1 < BINS && !isLeft(bin0+1)) bin0++;
+                size_t bin1 = bins.second[dim];
+                while (bin1 > 0 && !isRight(bin1)) bin1--;
+                while (bin1+1 < BINS && isRight(bin1+1)) bin1++;
+                numBegin[bin0][dim] += prim.size();
+                numEnd  [bin1][dim] += prim.size();
+                primsBegin[bin0][dim]++;
+                primsEnd  [bin1][dim]++;
+
+                if (bin0 == bin1) {
+                  bounds[bin0][dim].extend(binBounds(splitter.linearBounds(pbounds)));
+                  continue;
+                }
+
+                /* clip primitive against the slab of each overlapped bin */
+                for (size_t bin=bin0; bin<=bin1; bin++)
+                {
+                  BBox3fa slab = clip;
+                  if (bin != bin0) slab.lower[dim] = mapping.pos(bin+0,dim);
+                  if (bin != bin1) slab.upper[dim] = mapping.pos(bin+1,dim);
+                  const BBox3fa sbounds = splitter.bounds(slab);
+                  if (sbounds.empty()) continue;
+                  bounds[bin][dim].extend(binBounds(splitter.linearBounds(sbounds)));
+                }
+              }
+            }
+          }
+
+          __forceinline void bin_parallel(const SplitterFactory& splitterFactory, const PrimRefMB* prims, size_t begin, size_t end, size_t blockSize, size_t parallelThreshold, const BBox1f& time_range, const BBox3fa& clip, const SpatialBinMapping<BINS>& mapping)
+          {
+            if (likely(end-begin < parallelThreshold)) {
+              bin(splitterFactory,prims,begin,end,time_range,clip,mapping);
+            }
+            else
+            {
+              auto bin = [&](const range<size_t>& r) -> SpatialBinInfo {
+                SpatialBinInfo binner(empty); binner.bin(splitterFactory, prims, r.begin(), r.end(), time_range, clip, mapping); return binner;
+              };
+              *this = parallel_reduce(begin,end,blockSize,SpatialBinInfo(empty),bin,merge2);
+            }
+          }
+
+          /*! merges in other binning information */
+          __forceinline void merge (const SpatialBinInfo& other)
+          {
+            for (size_t i=0; i<BINS; i++)
+            {
+              for (size_t dim=0; dim<3; dim++)
+              {
+                bounds[i][dim].extend(other.bounds[i][dim]);
+                numBegin[i][dim] += other.numBegin[i][dim];
+                numEnd  [i][dim] += other.numEnd  [i][dim];
+                primsBegin[i][dim] += other.primsBegin[i][dim];
+                primsEnd  [i][dim] += other.primsEnd  [i][dim];
+              }
+            }
+          }
+
+          static __forceinline const SpatialBinInfo merge2(const SpatialBinInfo& a, const SpatialBinInfo& b) {
+            SpatialBinInfo r = a; r.merge(b); return r;
+          }
+
+          /*! finds the best split that does not exceed the number of allowed replications */
+          Split best(const SpatialBinMapping<BINS>& mapping, const size_t numPrims, const size_t maxReplications, const size_t logBlockSize, const BBox1f& time_range)
+          {
+            float bestSAH = inf;
+            int bestDim = -1;
+            float bestPos = 0.0f;
+            const size_t blockSize = size_t(1) << logBlockSize;
+
+            for (size_t dim=0; dim<3; dim++)
+            {
+              if (unlikely(mapping.invalid(dim)))
+                continue;
+
+              /* sweep from right to left and compute right bounds and counts */
+              BBox rbounds[BINS];
+              size_t rcounts[BINS], rprims[BINS];
+              BBox bx = empty; size_t count = 0, prims = 0;
+              for (size_t i=BINS-1; i>0; i--)
+              {
+                bx.extend(bounds[i][dim]);
+                count += numEnd[i][dim];
+                prims += primsEnd[i][dim];
+                rbounds[i] = bx; rcounts[i] = count; rprims[i] = prims;
+              }
+
+              /* sweep from left to right and compute SAH */
+              bx = empty; count = 0; prims = 0;
+              for (size_t i=1; i<BINS; i++)
+              {
+                bx.extend(bounds[i-1][dim]);
+                count += numBegin[i-1][dim];
+                prims += primsBegin[i-1][dim];
+                if (prims == 0 || rprims[i] == 0) continue;
+                if (prims+rprims[i] > numPrims+maxReplications) continue;
+                if (prims == numPrims && rprims[i] == numPrims) continue;
+                const size_t lCount = (count    +blockSize-1) >> logBlockSize;
+                const size_t rCount = (rcounts[i]+blockSize-1) >> logBlockSize;
+                const float sah = expectedApproxHalfArea(bx)*float(lCount) + expectedApproxHalfArea(rbounds[i])*float(rCount);
+                if (sah < bestSAH) {
+                  bestSAH = sah;
+                  bestDim = (int)dim;
+                  bestPos = mapping.pos(i,dim);
+                }
+              }
+            }
+
+            if (bestDim == -1) return Split();
+            return Split(bestSAH*time_range.size()*MBLUR_SPATIAL_SPLIT_THRESHOLD,(unsigned)Split::SPLIT_SPATIAL,bestDim,bestPos);
+          }
+
+        public:
+          BBox bounds[BINS][3];
+          size_t numBegin[BINS][3];     //!< number of time segments starting in bin
+          size_t numEnd[BINS][3];       //!< number of time segments ending in bin
+          size_t primsBegin[BINS][3];   //!< number of primitives starting in bin
+          size_t primsEnd[BINS][3];     //!< number of primitives ending in bin
+        };
+
+        /*! sets the maximal number of primitive replications for the entire build */
+        __forceinline void init(size_t numPrimitives, float splitFactor)
+        {
+          maxReplications = size_t(max(0.0f,splitFactor-1.0f)*float(numPrimitives));
+          numReplications = 0;
+        }
+
+        /*! bounds the part of the primitives inside the clip box */
+        __forceinline BBox3fa bounds(const SetMB& set, const BBox3fa& clip) const
+        {
+          auto reduce = [&](const range<size_t>& r) -> BBox3fa
+          {
+            BBox3fa bounds(empty);
+            for (size_t i=r.begin(); i<r.end(); i++)
+              bounds.extend(splitterFactory((*set.prims)[i],set.time_range).bounds(clip));
+            return bounds;
+          };
+          return parallel_reduce(set.object_range.begin(),set.object_range.end(),PARALLEL_FIND_BLOCK_SIZE,PARALLEL_THRESHOLD,BBox3fa(empty),reduce,
+                                 [&](const BBox3fa& b0, const BBox3fa& b1) -> BBox3fa { return merge(b0,b1); });
+        }
+
+        /*! linear bounds of the part of the primitives inside the clip box */
+        __forceinline LBBox3fa linearBounds(const SetMB& set, const BBox3fa& clip) const
+        {
+          auto reduce = [&](const range<size_t>& r) -> LBBox3fa
+          {
+            LBBox3fa lbounds(empty);
+            for (size_t i=r.begin(); i<r.end(); i++)
+            {
+              const auto splitter = splitterFactory((*set.prims)[i],set.time_range);
+              const BBox3fa cbounds = splitter.bounds(clip);
+              if (cbounds.empty()) continue;
+              lbounds.extend(splitter.linearBounds(cbounds));
+            }
+            return lbounds;
+          };
+          return parallel_reduce(set.object_range.begin(),set.object_range.end(),PARALLEL_FIND_BLOCK_SIZE,PARALLEL_THRESHOLD,LBBox3fa(empty),reduce,
+                                 [&](const LBBox3fa& b0, const LBBox3fa& b1) -> LBBox3fa { return embree::merge(b0,b1); });
+        }
+
+        /*! finds the best split */
+        const Split find(const SetMB& set, const BBox3fa& clip, const size_t logBlockSize)
+        {
+          const size_t replications = numReplications.load();
+          if (replications >= maxReplications)
+            return Split();
+
+          const BBox3fa cbounds = bounds(set,clip);
+          if (cbounds.empty())
+            return Split();
+
+          const SpatialBinMapping<BINS> mapping(CentGeomBBox3fa(cbounds,cbounds));
+          SpatialBinInfo binner(empty);
+          binner.bin_parallel(splitterFactory,set.prims->data(),set.object_range.begin(),set.object_range.end(),PARALLEL_FIND_BLOCK_SIZE,PARALLEL_THRESHOLD,set.time_range,clip,mapping);
+          return binner.best(mapping,set.size(),maxReplications-replications,logBlockSize,set.time_range);
+        }
+
+        /*! clips the primitives against the split plane and copies them into two new primref vectors */
+        std::unique_ptr<mvector<PrimRefMB>> split(const Split& split, const SetMB& set, const BBox3fa& clip, SetMB& lset, SetMB& rset)
+        {
+          const size_t dim = split.dim;
+          const float pos = split.fpos;
+          BBox3fa lclip = clip; lclip.upper[dim] = pos;
+          BBox3fa rclip = clip; rclip.lower[dim] = pos;
+          mvector<PrimRefMB>& prims = *set.prims;
+
+          std::unique_ptr<mvector<PrimRefMB>> new_vector(new mvector<PrimRefMB>(device,set.object_range.size()));
+          mvector<PrimRefMB>* lprims = new_vector.get();
+          mvector<PrimRefMB>* rprims = new mvector<PrimRefMB>(device,set.object_range.size());
+          std::atomic<size_t> lnum(0), rnum(0);
+
+          parallel_for(set.object_range.begin(),set.object_range.end(),PARALLEL_PARTITION_BLOCK_SIZE,[&](const range<size_t>& r)
+          {
+            PrimRefMB lbuf[PARALLEL_PARTITION_BLOCK_SIZE], rbuf[PARALLEL_PARTITION_BLOCK_SIZE];
+            for (size_t block=r.begin(); block<r.end(); block+=PARALLEL_PARTITION_BLOCK_SIZE)
+            {
+              size_t numLeft = 0, numRight = 0;
+              for (size_t i=block; i<min(block+PARALLEL_PARTITION_BLOCK_SIZE,r.end()); i++)
+              {
+                const PrimRefMB& prim = prims[i];
+                const auto splitter = splitterFactory(prim,set.time_range);
+                const BBox3fa pbounds = splitter.bounds(clip);
+                if (unlikely(pbounds.empty())) continue; // primitive does not touch the clip box
+                const bool right = pbounds.upper[dim] > pos;
+                const bool left  = pbounds.lower[dim] < pos || !right;
+
+                if (left) {
+                  const BBox3fa cbounds = right ? splitter.bounds(lclip) : pbounds;
+                  lbuf[numLeft++] = PrimRefMB(splitter.linearBounds(cbounds),prim.size(),prim.totalTimeSegments(),prim.ID());
+                }
+                if (right) {
+                  const BBox3fa cbounds = left ? splitter.bounds(rclip) : pbounds;
+                  rbuf[numRight++] = PrimRefMB(splitter.linearBounds(cbounds),prim.size(),prim.totalTimeSegments(),prim.ID());
+                }
+              }
+
+              const size_t lofs = lnum.fetch_add(numLeft);
+              for (size_t i=0; i<numLeft; i++) (*lprims)[lofs+i] = lbuf[i];
+              const size_t rofs = rnum.fetch_add(numRight);
+              for (size_t i=0; i<numRight; i++) (*rprims)[rofs+i] = rbuf[i];
+            }
+          });
+
+          numReplications += lnum+rnum-set.object_range.size();
+
+          auto reduce_left = [&](const range<size_t>& r) {
+            PrimInfoMB pinfo = empty;
+            for (size_t i=r.begin(); i<r.end(); i++) pinfo.add_primref((*lprims)[i]);
+            return pinfo;
+          };
+          PrimInfoMB linfo = parallel_reduce(size_t(0),size_t(lnum),PARALLEL_PARTITION_BLOCK_SIZE,PARALLEL_THRESHOLD,PrimInfoMB(empty),reduce_left,PrimInfoMB::merge2);
+          new (&lset) SetMB(linfo,lprims,range<size_t>(0,lnum),set.time_range);
+
+          auto reduce_right = [&](const range<size_t>& r) {
+            PrimInfoMB pinfo = empty;
+            for (size_t i=r.begin(); i<r.end(); i++) pinfo.add_primref((*rprims)[i]);
+            return pinfo;
+          };
+          PrimInfoMB rinfo = parallel_reduce(size_t(0),size_t(rnum),PARALLEL_PARTITION_BLOCK_SIZE,PARALLEL_THRESHOLD,PrimInfoMB(empty),reduce_right,PrimInfoMB::merge2);
+          new (&rset) SetMB(rinfo,rprims,range<size_t>(0,rnum),set.time_range);
+
+          /* the right primref vector gets owned by the child list of the builder through its pointer */
+          return new_vector;
+        }
+
+      private:
+        MemoryMonitorInterface* device;              // device to report memory usage to
+        const SplitterFactory splitterFactory;
+        size_t maxReplications;                      // maximal number of primitive replications
+        std::atomic<size_t> numReplications;         // number of primitive replications so far
+      };
+  }
+}
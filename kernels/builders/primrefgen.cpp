@@ -15,6 +15,7 @@
 // ======================================================================== //
 
 #include "primrefgen.h"
+#include "splitter.h"
 
 #include "../../common/algorithms/parallel_for_for.h"
 #include "../../common/algorithms/parallel_for_for_prefix_sum.h"
@@ -157,6 +158,152 @@ namespace embree
       return pinfo;
     }
 
+    /*! maximal number of splits of a single primitive during pre-splitting */
+    static const size_t MAX_PRESPLITS_PER_PRIMITIVE = 15;
+
+    /*! maximal level of the grid whose planes are used for pre-splitting */
+    static const size_t MAX_PRESPLIT_GRID_LEVEL = 16;
+
+    /*! chooses a split plane along the largest extent of the bounds,
+     *  preferring planes of a coarse regular grid over the scene
+     *  bounds, as these planes likely coincide with BVH node borders */
+    __forceinline bool presplitPlane(const BBox3fa& bounds, const BBox3fa& sceneBounds, size_t& dim_o, float& pos_o)
+    {
+      const size_t dim = maxDim(bounds.size());
+      const float lower = bounds.lower[dim];
+      const float upper = bounds.upper[dim];
+      if (!(lower < upper)) return false;
+
+      const float sceneLower = sceneBounds.lower[dim];
+      const float sceneSize  = sceneBounds.upper[dim]-sceneLower;
+      for (size_t level=1; level<=MAX_PRESPLIT_GRID_LEVEL; level++)
+      {
+        const float cellSize = sceneSize/float(size_t(1) << level);
+        const float pos = sceneLower + ceilf((lower-sceneLower)/cellSize)*cellSize;
+        if (lower < pos && pos < upper) {
+          dim_o = dim; pos_o = pos;
+          return true;
+        }
+      }
+
+      /* fallback to the center if no grid plane cuts the bounds */
+      dim_o = dim; pos_o = 0.5f*(lower+upper);
+      return lower < pos_o && pos_o < upper;
+    }
+
+    /*! splits a primitive reference into at most numSplits+1 pieces, always splitting the piece with the largest bounds */
+    template<typename SplitterFactory>
+    __forceinline size_t presplitPrimRef(const SplitterFactory& splitterFactory, const PrimRef& prim, const BBox3fa& sceneBounds, const size_t numSplits, PrimRef* pieces)
+    {
+      pieces[0] = prim;
+      if (numSplits == 0) return 1;
+
+      const auto splitter = splitterFactory(prim);
+      size_t numPieces = 1;
+      for (size_t i=0; i<numSplits; i++)
+      {
+        size_t best = 0;
+        for (size_t j=1; j<numPieces; j++)
+          if (halfArea(pieces[j].bounds()) > halfArea(pieces[best].bounds())) best = j;
+
+        size_t dim; float pos;
+        if (!presplitPlane(pieces[best].bounds(),sceneBounds,dim,pos)) break;
+
+        PrimRef left,right;
+        splitter(pieces[best],dim,pos,left,right);
+        if (left.bounds().empty() || right.bounds().empty()) break;
+        pieces[best] = left;
+        pieces[numPieces++] = right;
+      }
+      return numPieces;
+    }
+
+    /*! Splits primitive references with large bounds before binning
+     *  (early split clipping). The number of splits of each primitive
+     *  is proportional to the surface area of its bounds, and the
+     *  total number of primitive references is limited to replications
+     *  times the number of primitives. */
+    template<typename SplitterFactory>
+    PrimInfo presplitPrimRefArray(const SplitterFactory& splitterFactory, mvector<PrimRef>& prims, const PrimInfo& pinfo, const float replications, BuildProgressMonitor& progressMonitor)
+    {
+      const size_t numPrimitives = pinfo.size();
+      const size_t maxSplits = size_t(max(0.0f,replications-1.0f)*float(numPrimitives));
+      if (maxSplits == 0) return pinfo;
+
+      /* distribute the splits proportional to the surface area of the primitive bounds */
+      const float totalArea = parallel_reduce(size_t(0), numPrimitives, size_t(1024), 0.0f, [&](const range<size_t>& r) -> float
+      {
+        float area = 0.0f;
+        for (size_t j=r.begin(); j<r.end(); j++)
+          area += halfArea(prims[j].bounds());
+        return area;
+      }, std::plus<float>());
+      if (totalArea <= 0.0f) return pinfo;
+
+      const float splitsPerArea = float(maxSplits)/totalArea;
+      auto numSplits = [&] (const PrimRef& prim) -> size_t {
+        return min(size_t(splitsPerArea*halfArea(prim.bounds())),MAX_PRESPLITS_PER_PRIMITIVE);
+      };
+
+      /* count the additional primitive references */
+      progressMonitor(0);
+      ParallelPrefixSumState<size_t> pstate;
+      const size_t numExtraPrimitives = parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t
+      {
+        size_t num = 0;
+        PrimRef pieces[MAX_PRESPLITS_PER_PRIMITIVE+1];
+        for (size_t j=r.begin(); j<r.end(); j++)
+          num += presplitPrimRef(splitterFactory,prims[j],pinfo.geomBounds,numSplits(prims[j]),pieces)-1;
+        return num;
+      }, std::plus<size_t>());
+      if (numExtraPrimitives == 0) return pinfo;
+
+      /* the first piece replaces the original reference, all other pieces get appended */
+      prims.resize(numPrimitives+numExtraPrimitives);
+      progressMonitor(0);
+      parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t
+      {
+        size_t k = numPrimitives+base;
+        PrimRef pieces[MAX_PRESPLITS_PER_PRIMITIVE+1];
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          const size_t n = presplitPrimRef(splitterFactory,prims[j],pinfo.geomBounds,numSplits(prims[j]),pieces);
+          prims[j] = pieces[0];
+          for (size_t i=1; i<n; i++) prims[k++] = pieces[i];
+        }
+        return k-numPrimitives-base;
+      }, std::plus<size_t>());
+
+      return parallel_reduce(size_t(0), prims.size(), size_t(1024), PrimInfo(empty), [&](const range<size_t>& r) -> PrimInfo
+      {
+        PrimInfo info(empty);
+        for (size_t j=r.begin(); j<r.end(); j++)
+          info.add_center2(prims[j]);
+        return info;
+      }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+    }
+
+    /* only triangles and quads provide a splitter for pre-splitting */
+    template<typename Mesh>
+    __forceinline PrimInfo presplitPrimRefArray(Scene* scene, Mesh* dummy, mvector<PrimRef>& prims, const PrimInfo& pinfo, const float replications, BuildProgressMonitor& progressMonitor) {
+      return pinfo;
+    }
+
+    __forceinline PrimInfo presplitPrimRefArray(Scene* scene, TriangleMesh* dummy, mvector<PrimRef>& prims, const PrimInfo& pinfo, const float replications, BuildProgressMonitor& progressMonitor) {
+      return presplitPrimRefArray(TriangleSplitterFactory(scene),prims,pinfo,replications,progressMonitor);
+    }
+
+    __forceinline PrimInfo presplitPrimRefArray(Scene* scene, QuadMesh* dummy, mvector<PrimRef>& prims, const PrimInfo& pinfo, const float replications, BuildProgressMonitor& progressMonitor) {
+      return presplitPrimRefArray(QuadSplitterFactory(scene),prims,pinfo,replications,progressMonitor);
+    }
+
+    template<typename Mesh>
+    PrimInfo createPrimRefArrayPresplit(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor, const float replications)
+    {
+      const PrimInfo pinfo = createPrimRefArray<Mesh,false>(scene,prims,progressMonitor);
+      return presplitPrimRefArray(scene,(Mesh*)nullptr,prims,pinfo,replications,progressMonitor);
+    }
+
     template<typename Mesh>
     PrimInfo createPrimRefArrayMBlur(size_t timeSegment, Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
     {
@@ -338,6 +485,12 @@ namespace embree
     IF_ENABLED_USER(template PrimInfo createPrimRefArray<AccelSet COMMA false>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_USER(template PrimInfo createPrimRefArray<AccelSet COMMA true>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
 
+    IF_ENABLED_TRIS (template PrimInfo createPrimRefArrayPresplit<TriangleMesh>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor COMMA const float replications));
+    IF_ENABLED_QUADS(template PrimInfo createPrimRefArrayPresplit<QuadMesh>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor COMMA const float replications));
+    IF_ENABLED_CURVES (template PrimInfo createPrimRefArrayPresplit<NativeCurves>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor COMMA const float replications));
+    IF_ENABLED_CURVES(template PrimInfo createPrimRefArrayPresplit<LineSegments>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor COMMA const float replications));
+    IF_ENABLED_USER(template PrimInfo createPrimRefArrayPresplit<AccelSet>(Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor COMMA const float replications));
+
     IF_ENABLED_TRIS (template PrimInfo createPrimRefArrayMBlur<TriangleMesh>(size_t timeSegment COMMA Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_QUADS(template PrimInfo createPrimRefArrayMBlur<QuadMesh>(size_t timeSegment COMMA Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
     IF_ENABLED_CURVES(template PrimInfo createPrimRefArrayMBlur<LineSegments>(size_t timeSegment COMMA Scene* scene COMMA mvector<PrimRef>& prims COMMA BuildProgressMonitor& progressMonitor));
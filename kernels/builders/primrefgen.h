@@ -36,6 +36,9 @@ namespace embree
     template<typename Mesh, bool mblur>
       PrimInfo createPrimRefArray(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
+    template<typename Mesh>
+      PrimInfo createPrimRefArrayPresplit(Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor, const float replications);
+
     template<typename Mesh>
       PrimInfo createPrimRefArrayMBlur(size_t timeSegment, Scene* scene, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
 
@@ -18,6 +18,7 @@
 
 #include "../common/scene.h"
 #include "../common/primref.h"
+#include "../common/primref_mb.h"
 
 namespace embree
 {
@@ -175,6 +176,152 @@ namespace embree
     private:
       const Scene* scene;
     };
+
+    /*! clips linear bounds against a box that bounds the primitive over the entire time range */
+    __forceinline LBBox3fa clipLinearBounds(const LBBox3fa& lbounds, const BBox3fa& cbounds)
+    {
+      /* each bound that leaves the box at one end of the time range gets replaced by the constant box bound */
+      const Vec3ba clipLower = lt_mask(lbounds.bounds0.lower,cbounds.lower) | lt_mask(lbounds.bounds1.lower,cbounds.lower);
+      const Vec3ba clipUpper = gt_mask(lbounds.bounds0.upper,cbounds.upper) | gt_mask(lbounds.bounds1.upper,cbounds.upper);
+      const BBox3fa bounds0(select(clipLower,cbounds.lower,lbounds.bounds0.lower),select(clipUpper,cbounds.upper,lbounds.bounds0.upper));
+      const BBox3fa bounds1(select(clipLower,cbounds.lower,lbounds.bounds1.lower),select(clipUpper,cbounds.upper,lbounds.bounds1.upper));
+      return LBBox3fa(bounds0,bounds1);
+    }
+
+    /*! Splits a motion blurred polygon with N vertices. The geometry
+     *  swept over some time range is contained in the convex hull of
+     *  the vertices at the borders and inner time steps of that time
+     *  range, which gets clipped against each slab of the clip box. */
+    template<size_t N>
+      struct PolygonSplitterMB
+      {
+        static const size_t MAX_TIME_STEPS = 8;
+
+      protected:
+        template<typename Mesh>
+        __forceinline void init(const Mesh* mesh, const uint32_t (&v)[N], const unsigned primID, const BBox1f& time_range)
+        {
+          lbounds = mesh->linearBounds(primID,time_range);
+          numPoints = 0;
+
+          /* for many time steps we only clip the linear bounds */
+          const range<int> itime_range = getTimeSegmentRange(time_range,mesh->fnumTimeSegments);
+          if (itime_range.size()+1 > MAX_TIME_STEPS)
+            return;
+
+          addVertices(mesh,v,time_range.lower);
+          for (int itime=itime_range.begin()+1; itime<itime_range.end(); itime++)
+            for (size_t i=0; i<N; i++)
+              points[numPoints++] = mesh->vertex(v[i],itime);
+          addVertices(mesh,v,time_range.upper);
+
+          pbounds = empty;
+          for (size_t i=0; i<numPoints; i++)
+            pbounds.extend(points[i]);
+        }
+
+        template<typename Mesh>
+        __forceinline void addVertices(const Mesh* mesh, const uint32_t (&v)[N], const float time)
+        {
+          float ftime;
+          const int itime = getTimeSegment(time,mesh->fnumTimeSegments,ftime);
+          for (size_t i=0; i<N; i++)
+            points[numPoints++] = lerp(mesh->vertex(v[i],itime+0),mesh->vertex(v[i],itime+1),ftime);
+        }
+
+        /*! bounds the convex hull of all points inside the slab [lower,upper] of dimension dim */
+        __forceinline BBox3fa clipSlab(const size_t dim, const float lower, const float upper) const
+        {
+          BBox3fa bounds = empty;
+          for (size_t i=0; i<numPoints; i++)
+          {
+            const Vec3fa& p0 = points[i];
+            const float p0d = p0[dim];
+            if (lower <= p0d && p0d <= upper) bounds.extend(p0);
+
+            /* add intersections of all connecting lines with the slab planes */
+            for (size_t j=i+1; j<numPoints; j++)
+            {
+              const Vec3fa& p1 = points[j];
+              const float p1d = p1[dim];
+              if ((p0d < lower) != (p1d < lower))
+                bounds.extend(madd(Vec3fa((lower-p0d)/(p1d-p0d)),p1-p0,p0));
+              if ((p0d > upper) != (p1d > upper))
+                bounds.extend(madd(Vec3fa((upper-p0d)/(p1d-p0d)),p1-p0,p0));
+            }
+          }
+          return bounds;
+        }
+
+      public:
+
+        /*! bounds the part of the swept polygon inside some clip box */
+        __forceinline BBox3fa bounds(const BBox3fa& clip) const
+        {
+          if (numPoints == 0)
+            return intersect(lbounds.bounds(),clip);
+
+          BBox3fa bounds = intersect(pbounds,clip);
+          for (size_t dim=0; dim<3; dim++)
+            if (clip.lower[dim] > pbounds.lower[dim] || clip.upper[dim] < pbounds.upper[dim])
+              bounds = intersect(bounds,clipSlab(dim,clip.lower[dim],clip.upper[dim]));
+          return bounds;
+        }
+
+        /*! calculates linear bounds of the polygon part inside some box returned by the bounds function */
+        __forceinline LBBox3fa linearBounds(const BBox3fa& cbounds) const {
+          return clipLinearBounds(lbounds,cbounds);
+        }
+
+      private:
+        LBBox3fa lbounds;
+        BBox3fa pbounds;
+        Vec3fa points[N*MAX_TIME_STEPS];
+        size_t numPoints;
+      };
+
+    struct TriangleSplitterMB : public PolygonSplitterMB<3>
+    {
+      __forceinline TriangleSplitterMB(const Scene* scene, const PrimRefMB& prim, const BBox1f& time_range)
+      {
+        const TriangleMesh* mesh = scene->get<TriangleMesh>(prim.geomID());
+        init(mesh,mesh->triangle(prim.primID()).v,prim.primID(),time_range);
+      }
+    };
+
+    struct TriangleSplitterMBFactory
+    {
+      __forceinline TriangleSplitterMBFactory(const Scene* scene)
+        : scene(scene) {}
+
+      __forceinline TriangleSplitterMB operator() (const PrimRefMB& prim, const BBox1f& time_range) const {
+        return TriangleSplitterMB(scene,prim,time_range);
+      }
+
+    private:
+      const Scene* scene;
+    };
+
+    struct QuadSplitterMB : public PolygonSplitterMB<4>
+    {
+      __forceinline QuadSplitterMB(const Scene* scene, const PrimRefMB& prim, const BBox1f& time_range)
+      {
+        const QuadMesh* mesh = scene->get<QuadMesh>(prim.geomID());
+        init(mesh,mesh->quad(prim.primID()).v,prim.primID(),time_range);
+      }
+    };
+
+    struct QuadSplitterMBFactory
+    {
+      __forceinline QuadSplitterMBFactory(const Scene* scene)
+        : scene(scene) {}
+
+      __forceinline QuadSplitterMB operator() (const PrimRefMB& prim, const BBox1f& time_range) const {
+        return QuadSplitterMB(scene,prim,time_range);
+      }
+
+    private:
+      const Scene* scene;
+    };
   }
 }
-
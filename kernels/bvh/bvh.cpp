@@ -16,6 +16,7 @@
 
 #include "bvh.h"
 #include "bvh_statistics.h"
+#include "bvh_serializer.h"
 
 namespace embree
 {
@@ -41,6 +42,16 @@ namespace embree
     alloc.clear();
   }
 
+  template<int N>
+  void BVHN<N>::save(std::ostream& out) const {
+    BVHNSerializer<N>::save(this,out);
+  }
+
+  template<int N>
+  bool BVHN<N>::load(std::istream& in) {
+    return BVHNSerializer<N>::load(this,in);
+  }
+
   template<int N>
   void BVHN<N>::set (NodeRef root, const LBBox3fa& bounds, size_t numPrimitives)
   {
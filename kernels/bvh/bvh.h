@@ -1387,6 +1387,12 @@ namespace embree
     /*! clears the acceleration structure */
     void clear();
 
+    /*! writes the BVH into a relocatable image */
+    void save(std::ostream& out) const;
+
+    /*! restores the BVH from an image written by save */
+    bool load(std::istream& in);
+
     /*! sets BVH members after build */
     void set (NodeRef root, const LBBox3fa& bounds, size_t numPrimitives);
 
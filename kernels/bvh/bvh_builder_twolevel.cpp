@@ -125,9 +125,11 @@ namespace embree
           BVH*     object  = objects [objectID]; assert(object);
           Ref<Builder>& builder = builders[objectID].builder; assert(builder);
           
-          /* build object if it got modified */
-          if (mesh->isModified())
+          /* build object if it got modified or was just created for an unmodified mesh */
+          if (mesh->isModified() || builders[objectID].created) {
             builder->build();
+            builders[objectID].created = false;
+          }
 
           /* create build primitive */
           if (!object->getBounds().empty())
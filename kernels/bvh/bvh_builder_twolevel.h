@@ -120,18 +120,20 @@ namespace embree
       struct BuilderState
       {
         BuilderState ()
-        : builder(nullptr), quality(RTC_BUILD_QUALITY_LOW) {}
+        : builder(nullptr), quality(RTC_BUILD_QUALITY_LOW), created(false) {}
 
         BuilderState (const Ref<Builder>& builder, RTCBuildQuality quality)
-        : builder(builder), quality(quality) {}
+        : builder(builder), quality(quality), created(true) {}
         
         void clear() {
           builder = nullptr;
           quality = RTC_BUILD_QUALITY_LOW;
+          created = false;
         }
         
         Ref<Builder> builder;
         RTCBuildQuality quality;
+        bool created; //!< true if the object has not been built yet
       };
       
     public:
@@ -27,7 +27,7 @@ namespace embree
   class BVHFactory
   {
   public:
-    enum class BuildVariant     { STATIC, DYNAMIC, HIGH_QUALITY };
+    enum class BuildVariant     { STATIC, DYNAMIC, HIGH_QUALITY, MORTON };
     enum class IntersectVariant { FAST, ROBUST };
   };
 }
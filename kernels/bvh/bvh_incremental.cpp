@@ -0,0 +1,533 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh_incremental.h"
+
+#include "../geometry/triangle.h"
+#include "../geometry/trianglev.h"
+#include "../geometry/trianglei.h"
+#include "../geometry/quadv.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! updates that change more primitives than this fraction get performed as full rebuild */
+    MAYBE_UNUSED static const float maxUpdateFraction = 0.05f;
+
+    template<int N, typename Mesh, typename Primitive>
+    BVHNIncrementalT<N,Mesh,Primitive>::BVHNIncrementalT (BVH* bvh, Builder* builder, Mesh* mesh, size_t mode)
+      : bvh(bvh), builder(builder), mesh(mesh), alloc(nullptr), numPrimitives(0), cost(0.0), buildCost(0.0), bytesBuild(0), bytesUpdate(0) {}
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNIncrementalT<N,Mesh,Primitive>::clear()
+    {
+      if (builder)
+        builder->clear();
+
+      nodes.clear();
+      leaves.clear();
+      freeNodes.clear();
+      freeLeaves.clear();
+      primLeaf.clear();
+      primTopology.clear();
+      vertices.clear();
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNIncrementalT<N,Mesh,Primitive>::build()
+    {
+      if (!nodes.empty())
+      {
+        const bool updated = update();
+        bvh->alloc.cleanup();
+        if (updated) return;
+      }
+      rebuild();
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNIncrementalT<N,Mesh,Primitive>::rebuild()
+    {
+      builder->build();
+
+      nodes.clear();
+      leaves.clear();
+      freeNodes.clear();
+      freeLeaves.clear();
+      numPrimitives = 0;
+      cost = 0.0;
+      bytesBuild = 0;
+      bytesUpdate = 0;
+
+      /* only BVHs with an inner root node can get updated */
+      if (!bvh->root.isAlignedNode()) {
+        primLeaf.clear();
+        primTopology.clear();
+        vertices.clear();
+        return;
+      }
+
+      /* record primitives and vertices */
+      const size_t numPrims = mesh->size();
+      primLeaf.resize(numPrims);
+      primTopology.resize(numPrims);
+      parallel_for(size_t(0), numPrims, size_t(4096), [&] (const range<size_t>& r) {
+          for (size_t i=r.begin(); i<r.end(); i++) {
+            primLeaf[i] = invalidID;
+            primTopology[i] = PrimTopology(mesh,i);
+          }
+        });
+
+      const size_t numVertices = mesh->numVertices();
+      vertices.resize(numVertices);
+      parallel_for(size_t(0), numVertices, size_t(4096), [&] (const range<size_t>& r) {
+          for (size_t i=r.begin(); i<r.end(); i++)
+            vertices[i] = mesh->vertex(i);
+        });
+
+      /* record structure of the BVH */
+      init(bvh->root,invalidID,0,1);
+      numPrimitives = bvh->numPrimitives;
+      buildCost = cost/double(max(numPrimitives,size_t(1)));
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNIncrementalT<N,Mesh,Primitive>::init(NodeRef ref, unsigned parent, unsigned slot, unsigned depth)
+    {
+      const unsigned nodeID = allocNode();
+      AlignedNode* node = ref.alignedNode();
+      nodes[nodeID].node = node;
+      nodes[nodeID].parent = parent;
+      nodes[nodeID].slot = slot;
+      nodes[nodeID].depth = depth;
+      bytesBuild += sizeof(AlignedNode);
+
+      for (size_t i=0; i<N; i++)
+      {
+        const NodeRef child = node->child(i);
+        if (child == BVH::emptyNode) continue;
+
+        if (child.isAlignedNode())
+        {
+          nodes[nodeID].children[i] = (unsigned) nodes.size();
+          init(child,nodeID,(unsigned)i,depth+1);
+        }
+        else
+        {
+          assert(child.isLeaf());
+          const unsigned leafID = allocLeaf();
+          leaves[leafID].node = nodeID;
+          leaves[leafID].slot = (unsigned) i;
+          leaves[leafID].num = 0;
+          nodes[nodeID].children[i] = leafID | leafBit;
+
+          size_t items; const Primitive* prims = (const Primitive*) child.leaf(items);
+          for (size_t j=0; j<items; j++) {
+            for (size_t k=0; k<Primitive::max_size(); k++) {
+              if (!prims[j].valid(k)) break;
+              primLeaf[prims[j].primID(k)] = leafID;
+              leaves[leafID].num++;
+            }
+          }
+          bytesBuild += items*sizeof(Primitive);
+        }
+        cost += slotCost(nodeID,i);
+      }
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    unsigned BVHNIncrementalT<N,Mesh,Primitive>::allocNode()
+    {
+      unsigned nodeID;
+      if (freeNodes.size()) {
+        nodeID = freeNodes.back();
+        freeNodes.pop_back();
+      } else {
+        nodeID = (unsigned) nodes.size();
+        nodes.resize(nodes.size()+1);
+      }
+      for (size_t i=0; i<N; i++)
+        nodes[nodeID].children[i] = invalidID;
+      return nodeID;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    unsigned BVHNIncrementalT<N,Mesh,Primitive>::allocLeaf()
+    {
+      if (freeLeaves.size()) {
+        const unsigned leafID = freeLeaves.back();
+        freeLeaves.pop_back();
+        return leafID;
+      }
+      leaves.resize(leaves.size()+1);
+      return (unsigned) leaves.size()-1;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    float BVHNIncrementalT<N,Mesh,Primitive>::slotCost(unsigned nodeID, size_t slot) const
+    {
+      const unsigned childID = nodes[nodeID].children[slot];
+      if (childID == invalidID) return 0.0f;
+      const float weight = (childID & leafBit) ? float(leaves[childID & ~leafBit].num) : 1.0f;
+      return weight*halfArea(nodes[nodeID].node->bounds(slot));
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNIncrementalT<N,Mesh,Primitive>::setChild(unsigned nodeID, size_t slot, unsigned childID, NodeRef ref, const BBox3fa& bounds)
+    {
+      cost -= slotCost(nodeID,slot);
+      nodes[nodeID].children[slot] = childID;
+      nodes[nodeID].node->set(slot,ref,bounds);
+
+      if (childID & leafBit) {
+        leaves[childID & ~leafBit].node = nodeID;
+        leaves[childID & ~leafBit].slot = (unsigned) slot;
+      } else {
+        nodes[childID].parent = nodeID;
+        nodes[childID].slot = (unsigned) slot;
+      }
+      cost += slotCost(nodeID,slot);
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNIncrementalT<N,Mesh,Primitive>::removeChild(unsigned nodeID, size_t slot)
+    {
+      const size_t last = numChildren(nodeID)-1;
+      const unsigned childID = nodes[nodeID].children[slot];
+      if (childID & leafBit) freeLeaves.push_back(childID & ~leafBit);
+      else                   freeNodes.push_back(childID);
+      cost -= slotCost(nodeID,slot);
+      nodes[nodeID].children[slot] = invalidID;
+
+      /* fill the gap with the last child */
+      AlignedNode* node = nodes[nodeID].node;
+      if (slot != last) {
+        const unsigned lastID = nodes[nodeID].children[last];
+        const float lastCost = slotCost(nodeID,last);
+        setChild(nodeID,slot,lastID,node->child(last),node->bounds(last));
+        cost -= lastCost;
+      }
+      nodes[nodeID].children[last] = invalidID;
+      node->set(last,BVH::emptyNode,empty);
+
+      /* remove nodes that got empty */
+      if (last == 0) {
+        if (nodeID == 0) return false;
+        return removeChild(nodes[nodeID].parent,nodes[nodeID].slot);
+      }
+      refit(nodeID);
+      return true;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNIncrementalT<N,Mesh,Primitive>::refit(unsigned nodeID)
+    {
+      while (nodeID != 0)
+      {
+        const unsigned parent = nodes[nodeID].parent;
+        const unsigned slot = nodes[nodeID].slot;
+        const BBox3fa bounds = nodes[nodeID].node->bounds();
+        if (nodes[parent].node->bounds(slot) == bounds) break;
+
+        cost -= slotCost(parent,slot);
+        nodes[parent].node->setBounds(slot,bounds);
+        cost += slotCost(parent,slot);
+        nodeID = parent;
+      }
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNIncrementalT<N,Mesh,Primitive>::createLeaf(unsigned leafID, unsigned nodeID, size_t slot, PrimRef* prims, size_t num)
+    {
+      const size_t items = Primitive::blocks(num);
+      Primitive* accel = (Primitive*) alloc.malloc1(items*sizeof(Primitive),BVH::byteAlignment);
+      const NodeRef ref = BVH::encodeLeaf((char*)accel,items);
+      bytesUpdate += items*sizeof(Primitive);
+
+      BBox3fa bounds = empty;
+      for (size_t i=0; i<num; i++) {
+        bounds.extend(prims[i].bounds());
+        primLeaf[prims[i].primID()] = leafID;
+      }
+      size_t start = 0;
+      for (size_t i=0; i<items; i++)
+        accel[i].fill(prims,start,num,bvh->scene);
+
+      /* the slot might still contain the old version of this leaf */
+      cost -= slotCost(nodeID,slot);
+      nodes[nodeID].children[slot] = invalidID;
+      leaves[leafID].num = (unsigned) num;
+      setChild(nodeID,slot,leafID | leafBit,ref,bounds);
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    size_t BVHNIncrementalT<N,Mesh,Primitive>::gatherLeaf(unsigned leafID, PrimRef* prims) const
+    {
+      const Leaf& leaf = leaves[leafID];
+      const NodeRef ref = nodes[leaf.node].node->child(leaf.slot);
+
+      size_t num = 0;
+      size_t items; const Primitive* accel = (const Primitive*) ref.leaf(items);
+      for (size_t i=0; i<items; i++) {
+        for (size_t j=0; j<Primitive::max_size(); j++) {
+          if (!accel[i].valid(j)) break;
+          const unsigned primID = accel[i].primID(j);
+          if (primID < primLeaf.size() && primLeaf[primID] == leafID)
+            prims[num++] = PrimRef(mesh->bounds(primID),mesh->geomID,primID);
+        }
+      }
+      return num;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNIncrementalT<N,Mesh,Primitive>::insert(const PrimRef& prim)
+    {
+      enum { NONE, NEW_LEAF, MERGE_LEAF, SPLIT_LEAF, DESCEND };
+      const BBox3fa bounds = prim.bounds();
+      const float A = halfArea(bounds);
+
+      unsigned nodeID = 0;
+      while (true)
+      {
+        /* find the cheapest option to insert the primitive at this node, descending is estimated by a lower bound */
+        const size_t num = numChildren(nodeID);
+        int bestOp = NONE;
+        size_t bestSlot = num;
+        float bestCost = pos_inf;
+        if (num < N) {
+          bestOp = NEW_LEAF;
+          bestCost = A;
+        }
+
+        for (size_t i=0; i<num; i++)
+        {
+          const unsigned childID = nodes[nodeID].children[i];
+          const BBox3fa childBounds = nodes[nodeID].node->bounds(i);
+          const float Ac = halfArea(childBounds);
+          const float Am = halfArea(merge(childBounds,bounds));
+
+          if (childID & leafBit)
+          {
+            const size_t k = leaves[childID & ~leafBit].num;
+            const float mergeCost = float(k+1)*Am - float(k)*Ac;
+            if (k < Primitive::blocks(k)*Primitive::max_size() && mergeCost < bestCost) {
+              bestOp = MERGE_LEAF; bestSlot = i; bestCost = mergeCost;
+            }
+            const float splitCost = Am + A;
+            if (nodes[nodeID].depth+1 < BVH::maxBuildDepthLeaf && splitCost < bestCost) {
+              bestOp = SPLIT_LEAF; bestSlot = i; bestCost = splitCost;
+            }
+          }
+          else
+          {
+            const float descendCost = Am - Ac + A;
+            if (descendCost < bestCost) {
+              bestOp = DESCEND; bestSlot = i; bestCost = descendCost;
+            }
+          }
+        }
+
+        PrimRef prims[BVH::maxLeafBlocks*Primitive::max_size()];
+        switch (bestOp)
+        {
+        case NEW_LEAF: {
+          prims[0] = prim;
+          createLeaf(allocLeaf(),nodeID,bestSlot,prims,1);
+          refit(nodeID);
+          return true;
+        }
+        case MERGE_LEAF: {
+          const unsigned leafID = nodes[nodeID].children[bestSlot] & ~leafBit;
+          const size_t n = gatherLeaf(leafID,prims);
+          prims[n] = prim;
+          createLeaf(leafID,nodeID,bestSlot,prims,n+1);
+          refit(nodeID);
+          return true;
+        }
+        case SPLIT_LEAF: {
+          /* replace the leaf by a new node that contains the leaf and the new primitive */
+          const unsigned leafID = nodes[nodeID].children[bestSlot];
+          const NodeRef leafRef = nodes[nodeID].node->child(bestSlot);
+          const BBox3fa leafBounds = nodes[nodeID].node->bounds(bestSlot);
+
+          AlignedNode* node = (AlignedNode*) alloc.malloc0(sizeof(AlignedNode),BVH::byteNodeAlignment); node->clear();
+          bytesUpdate += sizeof(AlignedNode);
+          const unsigned newID = allocNode();
+          nodes[newID].node = node;
+          nodes[newID].depth = nodes[nodeID].depth+1;
+
+          setChild(nodeID,bestSlot,newID,BVH::encodeNode(node),leafBounds);
+          setChild(newID,0,leafID,leafRef,leafBounds);
+          prims[0] = prim;
+          createLeaf(allocLeaf(),newID,1,prims,1);
+          refit(newID);
+          return true;
+        }
+        case DESCEND: {
+          nodeID = nodes[nodeID].children[bestSlot];
+          break;
+        }
+        default:
+          return false;
+        }
+      }
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNIncrementalT<N,Mesh,Primitive>::update()
+    {
+      const size_t numOldPrims = primLeaf.size();
+      const size_t numNewPrims = mesh->size();
+      const size_t numOldVertices = vertices.size();
+      const size_t numNewVertices = mesh->numVertices();
+      if (numNewPrims == 0 || mesh->numTimeSteps != 1)
+        return false;
+
+      /* detect modified vertices */
+      std::vector<char> modifiedVertices(numNewVertices);
+      parallel_for(size_t(0), numNewVertices, size_t(4096), [&] (const range<size_t>& r) {
+          for (size_t i=r.begin(); i<r.end(); i++)
+            modifiedVertices[i] = i >= numOldVertices || mesh->vertex(i) != vertices[i];
+        });
+
+      /* detect primitives to remove and to insert, modified primitives get removed and inserted again */
+      std::vector<unsigned> removed;
+      avector<PrimRef> inserted;
+      SpinLock mutex;
+      parallel_for(size_t(0), max(numOldPrims,numNewPrims), size_t(4096), [&] (const range<size_t>& r)
+      {
+        std::vector<unsigned> localRemoved;
+        avector<PrimRef> localInserted;
+        for (size_t i=r.begin(); i<r.end(); i++)
+        {
+          const bool present = i < numOldPrims && primLeaf[i] != invalidID;
+          BBox3fa bounds = empty;
+          const bool valid = i < numNewPrims && mesh->buildBounds(i,&bounds);
+
+          if (present && valid)
+          {
+            const PrimTopology topology(mesh,i);
+            bool modified = !(topology == primTopology[i]);
+            for (size_t j=0; j<4 && !modified; j++)
+              modified = topology.v[j] != invalidID && modifiedVertices[topology.v[j]];
+            if (!modified) continue;
+          }
+          if (present) localRemoved.push_back((unsigned)i);
+          if (valid) localInserted.push_back(PrimRef(bounds,mesh->geomID,(unsigned)i));
+        }
+
+        if (localRemoved.size() || localInserted.size()) {
+          Lock<SpinLock> lock(mutex);
+          removed.insert(removed.end(),localRemoved.begin(),localRemoved.end());
+          for (size_t i=0; i<localInserted.size(); i++) inserted.push_back(localInserted[i]);
+        }
+      });
+
+      /* large updates get handled by a full rebuild */
+      if (float(removed.size()+inserted.size()) > maxUpdateFraction*float(numNewPrims))
+        return false;
+
+      std::sort(removed.begin(),removed.end());
+      std::sort(inserted.begin(),inserted.end(),[] (const PrimRef& a, const PrimRef& b) { return a.primID() < b.primID(); });
+      alloc = bvh->alloc.getCachedAllocator();
+
+      /* remove primitives from their leaves */
+      std::vector<unsigned> modifiedLeaves;
+      for (size_t i=0; i<removed.size(); i++) {
+        modifiedLeaves.push_back(primLeaf[removed[i]]);
+        primLeaf[removed[i]] = invalidID;
+      }
+      std::sort(modifiedLeaves.begin(),modifiedLeaves.end());
+      modifiedLeaves.erase(std::unique(modifiedLeaves.begin(),modifiedLeaves.end()),modifiedLeaves.end());
+      numPrimitives -= removed.size();
+
+      for (size_t i=0; i<modifiedLeaves.size(); i++)
+      {
+        const unsigned leafID = modifiedLeaves[i];
+        const unsigned nodeID = leaves[leafID].node;
+        const unsigned slot = leaves[leafID].slot;
+        PrimRef prims[BVH::maxLeafBlocks*Primitive::max_size()];
+        const size_t num = gatherLeaf(leafID,prims);
+        if (num) {
+          createLeaf(leafID,nodeID,slot,prims,num);
+          refit(nodeID);
+        }
+        else if (!removeChild(nodeID,slot))
+          return false;
+      }
+
+      /* insert new and modified primitives */
+      primLeaf.resize(numNewPrims,unsigned(invalidID));
+      primTopology.resize(numNewPrims);
+      for (size_t i=0; i<inserted.size(); i++)
+      {
+        const unsigned primID = inserted[i].primID();
+        primTopology[primID] = PrimTopology(mesh,primID);
+        if (!insert(inserted[i]))
+          return false;
+      }
+      numPrimitives += inserted.size();
+
+      /* remember modified vertices */
+      vertices.resize(numNewVertices);
+      parallel_for(size_t(0), numNewVertices, size_t(4096), [&] (const range<size_t>& r) {
+          for (size_t i=r.begin(); i<r.end(); i++)
+            if (modifiedVertices[i]) vertices[i] = mesh->vertex(i);
+        });
+
+      /* rebuild if the quality of the BVH or the amount of unused memory gets too bad */
+      const double relativeCost = cost/double(max(numPrimitives,size_t(1)));
+      if (relativeCost > (1.0+double(bvh->device->incremental_update_threshold))*buildCost)
+        return false;
+      if (bytesUpdate > bytesBuild)
+        return false;
+
+      bvh->set(bvh->root,LBBox3fa(nodes[0].node->bounds()),numPrimitives);
+      return true;
+    }
+
+#if defined(EMBREE_GEOMETRY_TRIANGLE)
+    Builder* BVH4Triangle4MeshBuilderSAH  (void* bvh, TriangleMesh* mesh, size_t mode);
+    Builder* BVH4Triangle4vMeshBuilderSAH (void* bvh, TriangleMesh* mesh, size_t mode);
+    Builder* BVH4Triangle4iMeshBuilderSAH (void* bvh, TriangleMesh* mesh, size_t mode);
+
+    Builder* BVH4Triangle4MeshIncrementalSAH  (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNIncrementalT<4,TriangleMesh,Triangle4> ((BVH4*)accel,BVH4Triangle4MeshBuilderSAH (accel,mesh,mode),mesh,mode); }
+    Builder* BVH4Triangle4vMeshIncrementalSAH (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNIncrementalT<4,TriangleMesh,Triangle4v>((BVH4*)accel,BVH4Triangle4vMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+    Builder* BVH4Triangle4iMeshIncrementalSAH (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNIncrementalT<4,TriangleMesh,Triangle4i>((BVH4*)accel,BVH4Triangle4iMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+#if  defined(__AVX__)
+    Builder* BVH8Triangle4MeshBuilderSAH  (void* bvh, TriangleMesh* mesh, size_t mode);
+    Builder* BVH8Triangle4vMeshBuilderSAH (void* bvh, TriangleMesh* mesh, size_t mode);
+    Builder* BVH8Triangle4iMeshBuilderSAH (void* bvh, TriangleMesh* mesh, size_t mode);
+
+    Builder* BVH8Triangle4MeshIncrementalSAH  (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNIncrementalT<8,TriangleMesh,Triangle4> ((BVH8*)accel,BVH8Triangle4MeshBuilderSAH (accel,mesh,mode),mesh,mode); }
+    Builder* BVH8Triangle4vMeshIncrementalSAH (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNIncrementalT<8,TriangleMesh,Triangle4v>((BVH8*)accel,BVH8Triangle4vMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+    Builder* BVH8Triangle4iMeshIncrementalSAH (void* accel, TriangleMesh* mesh, size_t mode) { return new BVHNIncrementalT<8,TriangleMesh,Triangle4i>((BVH8*)accel,BVH8Triangle4iMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+#endif
+#endif
+
+#if defined(EMBREE_GEOMETRY_QUAD)
+    Builder* BVH4Quad4vMeshBuilderSAH (void* bvh, QuadMesh* mesh, size_t mode);
+    Builder* BVH4Quad4vMeshIncrementalSAH (void* accel, QuadMesh* mesh, size_t mode) { return new BVHNIncrementalT<4,QuadMesh,Quad4v>((BVH4*)accel,BVH4Quad4vMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+
+#if  defined(__AVX__)
+    Builder* BVH8Quad4vMeshBuilderSAH (void* bvh, QuadMesh* mesh, size_t mode);
+    Builder* BVH8Quad4vMeshIncrementalSAH (void* accel, QuadMesh* mesh, size_t mode) { return new BVHNIncrementalT<8,QuadMesh,Quad4v>((BVH8*)accel,BVH8Quad4vMeshBuilderSAH(accel,mesh,mode),mesh,mode); }
+#endif
+#endif
+  }
+}
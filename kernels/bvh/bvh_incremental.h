@@ -0,0 +1,163 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh.h"
+#include "../common/scene_triangle_mesh.h"
+#include "../common/scene_quad_mesh.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! vertex indices of some triangle or quad, unused indices are set to -1 */
+    struct PrimTopology
+    {
+      __forceinline PrimTopology () {}
+
+      __forceinline PrimTopology (const TriangleMesh* mesh, size_t i)
+      {
+        const TriangleMesh::Triangle& tri = mesh->triangle(i);
+        v[0] = tri.v[0]; v[1] = tri.v[1]; v[2] = tri.v[2]; v[3] = -1;
+      }
+
+      __forceinline PrimTopology (const QuadMesh* mesh, size_t i)
+      {
+        const QuadMesh::Quad& quad = mesh->quad(i);
+        v[0] = quad.v[0]; v[1] = quad.v[1]; v[2] = quad.v[2]; v[3] = quad.v[3];
+      }
+
+      __forceinline bool operator== (const PrimTopology& other) const {
+        return v[0] == other.v[0] && v[1] == other.v[1] && v[2] == other.v[2] && v[3] == other.v[3];
+      }
+
+      unsigned v[4];
+    };
+
+    /*! Incremental update of the BVH of a single mesh. Primitives that
+     *  got removed or changed get deleted from their leaves, new and
+     *  changed primitives get inserted by SAH guided descent, and only
+     *  the nodes along the modified paths get refitted. The BVH gets
+     *  rebuilt from scratch using the wrapped builder if too many
+     *  primitives changed or the SAH cost of the BVH degraded by more
+     *  than the configured threshold. Changes are detected by comparing
+     *  against a copy of the vertex positions and vertex indices of the
+     *  mesh. */
+    template<int N, typename Mesh, typename Primitive>
+    class BVHNIncrementalT : public Builder
+    {
+      ALIGNED_CLASS;
+    public:
+
+      /*! Type shortcuts */
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AlignedNode AlignedNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+      static const unsigned invalidID = -1;          //!< marks unused child slots and primitives not stored in the BVH
+      static const unsigned leafBit = 0x80000000;    //!< marks child IDs that refer to leaves
+
+      /*! inner node of the BVH together with its position in the tree */
+      struct Node
+      {
+        AlignedNode* node;
+        unsigned parent;
+        unsigned slot;
+        unsigned depth;
+        unsigned children[N]; //!< node IDs or leaf IDs (tagged with leafBit) of the children
+      };
+
+      /*! leaf of the BVH together with its position in the tree */
+      struct Leaf
+      {
+        unsigned node;
+        unsigned slot;
+        unsigned num;         //!< number of primitives stored in the leaf
+      };
+
+    public:
+      BVHNIncrementalT (BVH* bvh, Builder* builder, Mesh* mesh, size_t mode);
+
+      virtual void build();
+
+      virtual void clear();
+
+    private:
+      /*! rebuilds the BVH from scratch and records its structure */
+      void rebuild();
+
+      /*! incrementally updates the BVH, returns false if a rebuild is required */
+      bool update();
+
+      /*! records the structure of the subtree rooted at some node */
+      void init(NodeRef ref, unsigned parent, unsigned slot, unsigned depth);
+
+      /*! returns the SAH cost contribution of some child slot */
+      float slotCost(unsigned nodeID, size_t slot) const;
+
+      /*! sets the child of some slot and updates the SAH cost */
+      void setChild(unsigned nodeID, size_t slot, unsigned childID, NodeRef ref, const BBox3fa& bounds);
+
+      /*! removes the child of some slot, returns false if the BVH got empty */
+      bool removeChild(unsigned nodeID, size_t slot);
+
+      /*! recalculates the bounds of all ancestors of some node */
+      void refit(unsigned nodeID);
+
+      /*! creates a leaf for some primitives and stores it in some slot */
+      void createLeaf(unsigned leafID, unsigned nodeID, size_t slot, PrimRef* prims, size_t num);
+
+      /*! gathers all primitives of some leaf that are still stored in it, returns their number */
+      size_t gatherLeaf(unsigned leafID, PrimRef* prims) const;
+
+      /*! inserts some primitive, returns false if a rebuild is required */
+      bool insert(const PrimRef& prim);
+
+      /*! returns the number of children of some node */
+      __forceinline size_t numChildren(unsigned nodeID) const
+      {
+        size_t num = 0;
+        while (num < N && nodes[nodeID].children[num] != invalidID) num++;
+        return num;
+      }
+
+      unsigned allocNode();
+      unsigned allocLeaf();
+
+    private:
+      BVH* bvh;
+      std::unique_ptr<Builder> builder;
+      Mesh* mesh;
+
+      FastAllocator::CachedAllocator alloc;  //!< allocator used for new nodes and leaves during an update
+      std::vector<Node> nodes;               //!< inner nodes of the BVH, node 0 is the root
+      std::vector<Leaf> leaves;              //!< leaves of the BVH
+      std::vector<unsigned> freeNodes;       //!< IDs of removed inner nodes
+      std::vector<unsigned> freeLeaves;      //!< IDs of removed leaves
+
+      std::vector<unsigned> primLeaf;        //!< leaf ID of each primitive
+      std::vector<PrimTopology> primTopology;//!< vertex indices of each primitive at the last update
+      avector<Vec3fa> vertices;              //!< vertex positions at the last update
+
+      size_t numPrimitives;                  //!< number of primitives stored in the BVH
+      double cost;                           //!< current SAH cost of the BVH
+      double buildCost;                      //!< SAH cost per primitive after the last rebuild
+      size_t bytesBuild;                     //!< bytes of nodes and leaves after the last rebuild
+      size_t bytesUpdate;                    //!< bytes of nodes and leaves allocated by updates since then
+    };
+  }
+}
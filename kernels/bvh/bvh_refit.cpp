@@ -16,6 +16,7 @@
 
 #include "bvh_refit.h"
 #include "bvh_statistics.h"
+#include "../../common/algorithms/parallel_reduce.h"
 
 #include "../geometry/linei.h"
 #include "../geometry/triangle.h"
@@ -178,13 +179,64 @@ namespace embree
       return merge<N>(bounds);
     }
 
+    /* returns the vertex buffer of the mesh if only some ranges of it got modified */
+    template<typename Mesh>
+    __forceinline const RawBufferView* partiallyModifiedVertices(const Mesh* mesh)
+    {
+      if (mesh->numTimeSteps != 1 || !mesh->vertices[0].isPartiallyModified()) return nullptr;
+      return &mesh->vertices[0];
+    }
+
+    __forceinline const RawBufferView* partiallyModifiedVertices(const AccelSet* mesh) {
+      return nullptr; // user geometries have no vertex buffer
+    }
+
+    /* returns the vertex indices of some primitive */
+    __forceinline size_t primVertices(const TriangleMesh* mesh, size_t primID, unsigned* v)
+    {
+      const TriangleMesh::Triangle& tri = mesh->triangle(primID);
+      v[0] = tri.v[0]; v[1] = tri.v[1]; v[2] = tri.v[2];
+      return 3;
+    }
+
+    __forceinline size_t primVertices(const QuadMesh* mesh, size_t primID, unsigned* v)
+    {
+      const QuadMesh::Quad& quad = mesh->quad(primID);
+      v[0] = quad.v[0]; v[1] = quad.v[1]; v[2] = quad.v[2]; v[3] = quad.v[3];
+      return 4;
+    }
+
+    __forceinline size_t primVertices(const LineSegments* mesh, size_t primID, unsigned* v)
+    {
+      v[0] = mesh->segment(primID); v[1] = v[0]+1;
+      return 2;
+    }
+
+    __forceinline size_t primVertices(const AccelSet* mesh, size_t primID, unsigned* v) {
+      return 0;
+    }
+
+    /* calls some function for the ID of each primitive of a leaf block */
+    template<typename Primitive, typename Func>
+    __forceinline void foreachPrimID(const Primitive& prim, const Func& f)
+    {
+      for (size_t i=0; i<Primitive::max_size(); i++)
+        if (prim.valid(i)) f(prim.primID(i));
+    }
+
+    template<typename Func>
+    __forceinline void foreachPrimID(const Object& prim, const Func& f) {
+      f(prim.primID());
+    }
+
     template<int N, typename Mesh, typename Primitive>
     BVHNRefitT<N,Mesh,Primitive>::BVHNRefitT (BVH* bvh, Builder* builder, Mesh* mesh, size_t mode)
-      : bvh(bvh), builder(builder), refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)), mesh(mesh) {}
+      : bvh(bvh), builder(builder), refitter(new BVHNRefitter<N>(bvh,*(typename BVHNRefitter<N>::LeafBoundsInterface*)this)), mesh(mesh), buildSAH(0.0), childSAH(0.0) {}
 
     template<int N, typename Mesh, typename Primitive>
     void BVHNRefitT<N,Mesh,Primitive>::clear()
     {
+      vertexLeafOffsets.clear();
       if (builder) 
         builder->clear();
     }
@@ -193,10 +245,200 @@ namespace embree
     void BVHNRefitT<N,Mesh,Primitive>::build()
     {
       if (mesh->topologyChanged()) {
-        builder->build();
+        rebuild();
+        return;
       }
-      else
+
+      const bool refitPartial = refitModifiedRanges();
+      if (!refitPartial)
         refitter->refit();
+
+      /* rebuild the BVH if refitting degraded its quality too much */
+      Device* device = bvh->device;
+      if (device->refit_rebuild_threshold <= 0.0f || bvh->root == BVH::emptyNode)
+        return;
+
+      double refitSAH = 0.0;
+      if (refitPartial) refitSAH = sah();
+      else {
+        refitSAH = BVHNStatistics<N>(bvh).sah();
+        childSAH = (refitSAH-1.0)*bvh->getLinearBounds().expectedHalfArea();
+      }
+
+      const bool degraded = refitSAH > (1.0+device->refit_rebuild_threshold)*buildSAH;
+      if (device->verbosity(2))
+        std::cout << "  refit sah = " << refitSAH << ", build sah = " << buildSAH << (degraded ? ", rebuilding" : "") << std::endl;
+
+      if (degraded) {
+        device->numRefitRebuilds++;
+        rebuild();
+      }
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNRefitT<N,Mesh,Primitive>::rebuild()
+    {
+      vertexLeafOffsets.clear();
+      builder->build();
+
+      if (bvh->device->refit_rebuild_threshold > 0.0f && bvh->root != BVH::emptyNode)
+        buildSAH = BVHNStatistics<N>(bvh).sah();
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    double BVHNRefitT<N,Mesh,Primitive>::sah() const
+    {
+      /* the root node contributes a cost of one */
+      return 1.0 + childSAH/bvh->getLinearBounds().expectedHalfArea();
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    bool BVHNRefitT<N,Mesh,Primitive>::refitModifiedRanges()
+    {
+      const RawBufferView* vertices = partiallyModifiedVertices(mesh);
+      if (!vertices) return false;
+
+      /* the parallel full refit is faster if large parts of the mesh got modified */
+      const std::vector<range<size_t>>& ranges = vertices->getModifiedRanges();
+      size_t numModified = 0;
+      for (const range<size_t>& r : ranges) numModified += r.size();
+      if (numModified > vertices->size()/4) return false;
+
+      if (vertexLeafOffsets.size() != vertices->size()+1)
+        initModifiedRanges(vertices->size());
+      if (nodes.empty()) return false;
+
+      /* gather all leaves referencing some modified vertex */
+      std::vector<unsigned> modifiedLeaves;
+      for (const range<size_t>& r : ranges)
+      {
+        for (size_t v=r.begin(); v<r.end(); v++)
+        {
+          for (size_t i=vertexLeafOffsets[v]; i<vertexLeafOffsets[v+1]; i++)
+          {
+            const unsigned leafID = vertexLeaves[i];
+            if (leafModified[leafID]) continue;
+            leafModified[leafID] = true;
+            modifiedLeaves.push_back(leafID);
+          }
+        }
+      }
+
+      /* recalculate the bounds of these leaves */
+      childSAH += parallel_reduce(size_t(0), modifiedLeaves.size(), size_t(256), 0.0, [&] (const range<size_t>& r) -> double {
+          double dSAH = 0.0;
+          for (size_t i=r.begin(); i<r.end(); i++)
+          {
+            const Leaf& leaf = leaves[modifiedLeaves[i]];
+            AlignedNode* node = nodes[leaf.node].node;
+            const BBox3fa bounds = leafBounds(node->child(leaf.slot));
+            size_t num; node->child(leaf.slot).leaf(num);
+            dSAH += double(num)*(halfArea(bounds)-halfArea(node->bounds(leaf.slot)));
+            node->setBounds(leaf.slot,bounds);
+          }
+          return dSAH;
+        }, std::plus<double>());
+
+      /* propagate the bounds towards the root, as nodes are stored in
+       * depth first order the heap returns children before their parents */
+      std::vector<unsigned> heap;
+      for (const unsigned leafID : modifiedLeaves)
+      {
+        leafModified[leafID] = false;
+        const unsigned nodeID = leaves[leafID].node;
+        if (nodeModified[nodeID]) continue;
+        nodeModified[nodeID] = true;
+        heap.push_back(nodeID);
+      }
+      std::make_heap(heap.begin(),heap.end());
+
+      while (!heap.empty())
+      {
+        std::pop_heap(heap.begin(),heap.end());
+        const unsigned nodeID = heap.back();
+        heap.pop_back();
+        nodeModified[nodeID] = false;
+
+        const BBox3fa bounds = nodes[nodeID].node->bounds();
+        if (nodeID == 0) {
+          bvh->bounds = LBBox3fa(bounds);
+          continue;
+        }
+
+        /* stop at nodes whose bounds did not change */
+        const unsigned parentID = nodes[nodeID].parent;
+        AlignedNode* parent = nodes[parentID].node;
+        const BBox3fa oldBounds = parent->bounds(nodes[nodeID].slot);
+        if (oldBounds.lower == bounds.lower && oldBounds.upper == bounds.upper) continue;
+        childSAH += halfArea(bounds)-halfArea(oldBounds);
+        parent->setBounds(nodes[nodeID].slot,bounds);
+
+        if (nodeModified[parentID]) continue;
+        nodeModified[parentID] = true;
+        heap.push_back(parentID);
+        std::push_heap(heap.begin(),heap.end());
+      }
+      return true;
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNRefitT<N,Mesh,Primitive>::initModifiedRanges(size_t numVertices)
+    {
+      nodes.clear();
+      leaves.clear();
+      childSAH = 0.0;
+      std::vector<std::pair<unsigned,unsigned>> vertexLeafPairs;
+      if (bvh->root.isAlignedNode())
+        initModifiedRanges(bvh->root,0,0,vertexLeafPairs);
+
+      /* sort the leaves by the vertices they reference */
+      vertexLeafOffsets.assign(numVertices+1,0);
+      for (const auto& p : vertexLeafPairs) {
+        assert(p.first < numVertices);
+        vertexLeafOffsets[p.first+1]++;
+      }
+      for (size_t v=0; v<numVertices; v++)
+        vertexLeafOffsets[v+1] += vertexLeafOffsets[v];
+
+      std::vector<unsigned> offsets(vertexLeafOffsets.begin(),vertexLeafOffsets.end()-1);
+      vertexLeaves.resize(vertexLeafPairs.size());
+      for (const auto& p : vertexLeafPairs)
+        vertexLeaves[offsets[p.first]++] = p.second;
+
+      leafModified.assign(leaves.size(),false);
+      nodeModified.assign(nodes.size(),false);
+    }
+
+    template<int N, typename Mesh, typename Primitive>
+    void BVHNRefitT<N,Mesh,Primitive>::initModifiedRanges(NodeRef ref, unsigned parent, unsigned slot, std::vector<std::pair<unsigned,unsigned>>& vertexLeafPairs)
+    {
+      if (ref.isAlignedNode())
+      {
+        const unsigned nodeID = unsigned(nodes.size());
+        AlignedNode* node = ref.alignedNode();
+        nodes.push_back({ node, parent, slot });
+        for (size_t i=0; i<N; i++) {
+          if (node->child(i) == BVH::emptyNode) continue;
+          if (node->child(i).isAlignedNode()) childSAH += halfArea(node->bounds(i));
+          initModifiedRanges(node->child(i),nodeID,unsigned(i),vertexLeafPairs);
+        }
+        return;
+      }
+
+      const unsigned leafID = unsigned(leaves.size());
+      leaves.push_back({ parent, slot });
+
+      size_t num; const Primitive* prims = (const Primitive*) ref.leaf(num);
+      childSAH += double(num)*halfArea(nodes[parent].node->bounds(slot));
+      for (size_t i=0; i<num; i++)
+      {
+        foreachPrimID(prims[i], [&] (unsigned primID) {
+            unsigned v[4];
+            const size_t numVertices = primVertices(mesh,primID,v);
+            for (size_t j=0; j<numVertices; j++)
+              vertexLeafPairs.push_back(std::make_pair(v[j],leafID));
+          });
+      }
     }
 
     template class BVHNRefitter<4>;
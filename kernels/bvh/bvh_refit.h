@@ -98,11 +98,52 @@ namespace embree
         return bounds;
       }
       
+    private:
+      /*! rebuilds the BVH and records its SAH cost if quality monitoring is enabled */
+      void rebuild();
+
+      /*! returns the current SAH cost of the BVH */
+      double sah() const;
+
+      /*! refits only the leaves referencing modified vertex ranges and their ancestors, returns false if not possible */
+      bool refitModifiedRanges();
+
+      /*! records the parents of all nodes and leaves and the leaves referencing each vertex */
+      void initModifiedRanges(size_t numVertices);
+
+      /*! records the structure of the subtree rooted at some node */
+      void initModifiedRanges(NodeRef ref, unsigned parent, unsigned slot, std::vector<std::pair<unsigned,unsigned>>& vertexLeafPairs);
+
+      /*! inner node of the BVH together with its position in the tree */
+      struct Node
+      {
+        AlignedNode* node;
+        unsigned parent;
+        unsigned slot;
+      };
+
+      /*! leaf of the BVH together with its position in the tree */
+      struct Leaf
+      {
+        unsigned node;
+        unsigned slot;
+      };
+
     private:
       BVH* bvh;
       std::unique_ptr<Builder> builder;
       std::unique_ptr<BVHNRefitter<N>> refitter;
       Mesh* mesh;
+
+      double buildSAH;                          //!< SAH cost of the BVH after the last rebuild
+      double childSAH;                          //!< surface area of all child slots weighted by their number of traversal steps
+
+      std::vector<Node> nodes;                  //!< inner nodes in depth first order, node 0 is the root
+      std::vector<Leaf> leaves;                 //!< leaves of the BVH
+      std::vector<unsigned> vertexLeafOffsets;  //!< offset of the leaves referencing each vertex, empty if not initialized
+      std::vector<unsigned> vertexLeaves;       //!< leaves referencing each vertex
+      std::vector<char> leafModified;           //!< marks leaves already gathered during a partial refit
+      std::vector<char> nodeModified;           //!< marks nodes already scheduled during a partial refit
     };
   }
 }
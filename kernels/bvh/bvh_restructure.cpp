@@ -0,0 +1,249 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh_restructure.h"
+#include "bvh_statistics.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    template<int N>
+    BVHNRestructure<N>::BVHNRestructure (BVH* bvh, double timeBudget)
+      : bvh(bvh), deadline(getSeconds()+timeBudget), numRestructured(0) {}
+
+    template<int N>
+    size_t BVHNRestructure<N>::restructure(size_t maxIterations)
+    {
+      size_t numTotal = 0;
+      for (size_t i=0; i<maxIterations; i++)
+      {
+        numRestructured = 0;
+        recurse(bvh->root,1);
+        numTotal += numRestructured;
+
+        /* stop when the tree converged or the time budget is used up */
+        if (numRestructured == 0 || timeout())
+          break;
+      }
+      return numTotal;
+    }
+
+    template<int N>
+    void BVHNRestructure<N>::restructure(BVH* bvh)
+    {
+      Device* device = bvh->device;
+      if (device->restructure_time_budget <= 0.0f || device->restructure_iterations == 0)
+        return;
+
+      if (!bvh->root.isAlignedNode())
+        return;
+
+      const double sah0 = device->verbosity(2) ? BVHNStatistics<N>(bvh).sah() : 0.0;
+      BVHNRestructure<N> restructurer(bvh,1E-3*double(device->restructure_time_budget));
+      const size_t numRestructured = restructurer.restructure(device->restructure_iterations);
+
+      if (device->verbosity(2)) {
+        const double sah1 = BVHNStatistics<N>(bvh).sah();
+        std::cout << "  restructured " << numRestructured << " treelets, sah = " << sah0 << " -> " << sah1 << std::endl;
+      }
+    }
+
+    template<int N>
+    size_t BVHNRestructure<N>::recurse(NodeRef ref, size_t depth)
+    {
+      /* leaves cannot get restructured, other node types are never moved down */
+      if (ref.isBarrier()) return BVH::maxBuildDepth;
+      if (ref.isLeaf()) return 0;
+      if (!ref.isAlignedNode()) return BVH::maxBuildDepth;
+      AlignedNode* node = ref.alignedNode();
+
+      /* restructure all children first */
+      size_t heights[N];
+      if (depth < PARALLEL_DEPTH)
+      {
+        parallel_for(size_t(0), size_t(N), size_t(1), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++)
+              heights[i] = recurse(node->child(i),depth+1);
+          });
+      }
+      else
+      {
+        for (size_t i=0; i<N; i++)
+          heights[i] = recurse(node->child(i),depth+1);
+      }
+
+      /* every successful restructuring can enable a further one */
+      if (!timeout())
+      {
+        for (size_t i=0; i<N && restructureNode(node,depth,heights); i++)
+          numRestructured++;
+      }
+
+      size_t height = 0;
+      for (size_t i=0; i<N; i++)
+        height = max(height,heights[i]);
+      return height+1;
+    }
+
+    template<int N>
+    size_t BVHNRestructure<N>::cluster(const Item* items, size_t numItems, size_t numNodes, Group* groups) const
+    {
+      /* every entry starts as its own group */
+      size_t numGroups = numItems;
+      for (size_t i=0; i<numItems; i++) {
+        groups[i].bounds = items[i].bounds;
+        groups[i].items = size_t(1) << i;
+        groups[i].size = 1;
+        groups[i].movable = items[i].movable;
+      }
+
+      /* merge groups until they fit into the root, then continue as long as this reduces the cost */
+      size_t numMulti = 0;
+      while (true)
+      {
+        float bestDelta = numGroups > N ? float(pos_inf) : 0.0f;
+        size_t bestA = -1, bestB = -1;
+        for (size_t a=0; a<numGroups; a++)
+        {
+          if (!groups[a].movable) continue;
+          for (size_t b=a+1; b<numGroups; b++)
+          {
+            if (!groups[b].movable) continue;
+            if (groups[a].size+groups[b].size > N) continue;
+
+            /* every group of multiple entries requires one inner node */
+            const size_t multi = numMulti + 1 - (groups[a].size > 1) - (groups[b].size > 1);
+            if (multi > numNodes) continue;
+
+            const float delta = halfArea(merge(groups[a].bounds,groups[b].bounds)) - groups[a].cost() - groups[b].cost();
+            if (delta < bestDelta) {
+              bestDelta = delta;
+              bestA = a; bestB = b;
+            }
+          }
+        }
+        if (bestA == size_t(-1)) break;
+
+        numMulti = numMulti + 1 - (groups[bestA].size > 1) - (groups[bestB].size > 1);
+        groups[bestA].bounds.extend(groups[bestB].bounds);
+        groups[bestA].items |= groups[bestB].items;
+        groups[bestA].size += groups[bestB].size;
+        groups[bestB] = groups[--numGroups];
+      }
+      return numGroups <= N ? numGroups : 0;
+    }
+
+    template<int N>
+    bool BVHNRestructure<N>::restructureNode(AlignedNode* node, size_t depth, size_t* heights)
+    {
+      /* open the inner children with largest surface area */
+      size_t opened[MAX_OPENED];
+      size_t numOpened = 0;
+      for (size_t i=0; i<N; i++)
+      {
+        const NodeRef ref = node->child(i);
+        if (ref.isBarrier() || !ref.isAlignedNode()) continue;
+
+        size_t pos = numOpened;
+        const float A = halfArea(node->bounds(i));
+        while (pos > 0 && halfArea(node->bounds(opened[pos-1])) < A) {
+          if (pos < MAX_OPENED) opened[pos] = opened[pos-1];
+          pos--;
+        }
+        if (pos < MAX_OPENED) opened[pos] = i;
+        numOpened = min(numOpened+1,MAX_OPENED);
+      }
+      if (numOpened == 0)
+        return false;
+
+      /* gather entries of the treelet */
+      Item items[MAX_ITEMS];
+      size_t numItems = 0;
+      bool isOpened[N];
+      for (size_t i=0; i<N; i++) isOpened[i] = false;
+      for (size_t i=0; i<numOpened; i++) isOpened[opened[i]] = true;
+
+      for (size_t i=0; i<N; i++) {
+        if (isOpened[i] || node->child(i) == BVH::emptyNode) continue;
+        items[numItems++] = { node->child(i), node->bounds(i), heights[i], depth+2+heights[i] <= BVH::maxBuildDepth };
+      }
+
+      float oldCost = 0.0f;
+      NodeRef nodes[MAX_OPENED];
+      for (size_t i=0; i<numOpened; i++)
+      {
+        nodes[i] = node->child(opened[i]);
+        const AlignedNode* child = nodes[i].alignedNode();
+        const size_t height = heights[opened[i]] > 0 ? heights[opened[i]]-1 : 0;
+        BBox3fa bounds = empty;
+        for (size_t j=0; j<N; j++) {
+          if (child->child(j) == BVH::emptyNode) continue;
+          items[numItems++] = { child->child(j), child->bounds(j), height, true };
+          bounds.extend(child->bounds(j));
+        }
+        oldCost += halfArea(bounds);
+      }
+
+      /* only accept changes that noticeably reduce the surface area */
+      Group groups[MAX_ITEMS];
+      const size_t numGroups = cluster(items,numItems,numOpened,groups);
+      if (numGroups == 0) return false;
+
+      float newCost = 0.0f;
+      for (size_t i=0; i<numGroups; i++)
+        newCost += groups[i].cost();
+      if (!(newCost < (1.0f-1E-3f)*oldCost))
+        return false;
+
+      /* refill the root, opened nodes not required anymore get dropped */
+      node->clear();
+      size_t numNodes = 0;
+      for (size_t i=0; i<numGroups; i++)
+      {
+        const Group& group = groups[i];
+        if (group.size == 1) {
+          const Item& item = items[__bsf(group.items)];
+          node->set(i,item.ref,item.bounds);
+          heights[i] = item.height;
+          continue;
+        }
+
+        AlignedNode* child = nodes[numNodes].alignedNode();
+        child->clear();
+        size_t height = 0;
+        size_t slot = 0;
+        for (size_t mask=group.items; mask; mask=__btc(mask,__bsf(mask))) {
+          const Item& item = items[__bsf(mask)];
+          child->set(slot++,item.ref,item.bounds);
+          height = max(height,item.height+1);
+        }
+        node->set(i,nodes[numNodes++],group.bounds);
+        heights[i] = height;
+      }
+      for (size_t i=numGroups; i<N; i++)
+        heights[i] = 0;
+
+      return true;
+    }
+
+    template class BVHNRestructure<4>;
+#if defined(__AVX__)
+    template class BVHNRestructure<8>;
+#endif
+  }
+}
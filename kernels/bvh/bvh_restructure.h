@@ -0,0 +1,96 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Treelet restructuring of aligned BVH nodes. Each treelet
+     *  consists of some node and its children with largest surface
+     *  area. The entries of these nodes get regrouped by agglomerative
+     *  clustering such that the summed surface area of the inner
+     *  nodes of the treelet gets minimal. Treelets are processed
+     *  bottom-up with independent subtrees processed in parallel. */
+    template<int N>
+    class BVHNRestructure
+    {
+      /*! Type shortcuts */
+      typedef BVHN<N> BVH;
+      typedef typename BVH::AlignedNode AlignedNode;
+      typedef typename BVH::NodeRef NodeRef;
+
+      static const size_t MAX_OPENED = (N==4) ? 4 : 2;    //!< maximal number of children opened per treelet
+      static const size_t MAX_ITEMS = N+MAX_OPENED*(N-1); //!< maximal number of entries of a treelet
+
+      /*! entry of a treelet, either a child of the treelet root or a child of an opened node */
+      struct Item
+      {
+        NodeRef ref;
+        BBox3fa bounds;
+        size_t height;   //!< conservative height of the subtree
+        bool movable;    //!< true if the item can get moved one level down
+      };
+
+      /*! group of treelet entries that get stored in one node */
+      struct Group
+      {
+        BBox3fa bounds;
+        size_t items;    //!< bitmask of contained entries
+        size_t size;     //!< number of contained entries
+        bool movable;    //!< true if all entries can get moved one level down
+
+        __forceinline float cost() const { return size > 1 ? halfArea(bounds) : 0.0f; }
+      };
+
+    public:
+
+      /*! Constructor. The time budget is specified in seconds. */
+      BVHNRestructure (BVH* bvh, double timeBudget);
+
+      /*! performs up to maxIterations restructuring passes and returns the number of modified treelets */
+      size_t restructure(size_t maxIterations);
+
+      /*! restructures the BVH if enabled in the device configuration */
+      static void restructure(BVH* bvh);
+
+    private:
+      /*! restructures all treelets of some subtree bottom-up and returns the height of the subtree */
+      size_t recurse(NodeRef ref, size_t depth);
+
+      /*! restructures the treelet rooted at some node, returns true if the node got modified */
+      bool restructureNode(AlignedNode* node, size_t depth, size_t* heights);
+
+      /*! clusters the treelet entries into at most N groups using at most numNodes inner nodes, returns the number of groups */
+      size_t cluster(const Item* items, size_t numItems, size_t numNodes, Group* groups) const;
+
+      /*! returns true if the time budget got used up */
+      __forceinline bool timeout() const {
+        return getSeconds() > deadline;
+      }
+
+    public:
+      BVH* bvh;                              //!< BVH to restructure
+      double deadline;                       //!< time when to stop restructuring
+      std::atomic<size_t> numRestructured;   //!< number of treelets modified in current pass
+
+      static const size_t PARALLEL_DEPTH = (N==4) ? 4 : 3; //!< depth up to which subtrees are processed in parallel
+    };
+  }
+}
@@ -0,0 +1,176 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "bvh_serializer.h"
+
+namespace embree
+{
+  /*! identifies a BVH image */
+  static const uint64_t BVH_IMAGE_MAGIC = 0x474d494e48564245; // "EBVHNIMG"
+
+  template<int N>
+  void BVHNSerializer<N>::save(const BVH* bvh, std::ostream& out)
+  {
+    /* first pass calculates the layout of the image */
+    BVHNSerializer<N> layout(bvh,nullptr);
+    const size_t root = layout.serialize(bvh->root);
+
+    Header header;
+    header.bounds = bvh->bounds;
+    header.magic = BVH_IMAGE_MAGIC;
+    header.type = bvh->type;
+    header.width = N;
+    std::fill(header.primTy,header.primTy+sizeof(header.primTy),0);
+    strncpy(header.primTy,bvh->primTy->name.c_str(),sizeof(header.primTy)-1);
+    header.primBytes = bvh->primTy->bytes;
+    header.numPrimitives = bvh->numPrimitives;
+    header.numVertices = bvh->numVertices;
+    header.root = root;
+    header.bytes = layout.bytes;
+    header.reserved = 0;
+    out.write((const char*)&header,sizeof(Header));
+
+    /* second pass writes the nodes and leaves */
+    BVHNSerializer<N> writer(bvh,&out);
+    writer.serialize(bvh->root);
+    assert(writer.bytes == header.bytes);
+    
+    if (!out)
+      throw_RTCError(RTC_ERROR_UNKNOWN,"error writing BVH image");
+  }
+
+  template<int N>
+  bool BVHNSerializer<N>::load(BVH* bvh, std::istream& in)
+  {
+    Header header;
+    in.read((char*)&header,sizeof(Header));
+    if (!in) return false;
+
+    /* the image has to match the BVH layout of this build */
+    if (header.magic != BVH_IMAGE_MAGIC) return false;
+    if (header.type != uint32_t(bvh->type) || header.width != N) return false;
+    if (header.primBytes != bvh->primTy->bytes) return false;
+    if (strncmp(header.primTy,bvh->primTy->name.c_str(),sizeof(header.primTy)) != 0) return false;
+
+    double t0 = bvh->preBuild("BVHNSerializer");
+    bvh->alloc.clear();
+
+    NodeRef root = BVH::emptyNode;
+    if (header.bytes)
+    {
+      /* read the image into a single block of the allocator */
+      bvh->alloc.init(header.bytes,header.bytes,header.bytes);
+      char* base = (char*) bvh->alloc.specialAlloc(header.bytes);
+      in.read(base,header.bytes);
+      if (!in) {
+        bvh->clear();
+        return false;
+      }
+      root = relocate(base,header.bytes,header.primBytes,header.root);
+    }
+    
+    bvh->set(root,header.bounds,header.numPrimitives);
+    bvh->numVertices = header.numVertices;
+    bvh->postBuild(t0);
+    return true;
+  }
+
+  template<int N>
+  size_t BVHNSerializer<N>::nodeBytes(NodeRef node)
+  {
+    if      (node.isAlignedNode())      return sizeof(AlignedNode);
+    else if (node.isAlignedNodeMB())    return sizeof(AlignedNodeMB);
+    else if (node.isAlignedNodeMB4D())  return sizeof(AlignedNodeMB4D);
+    else if (node.isUnalignedNode())    return sizeof(UnalignedNode);
+    else if (node.isUnalignedNodeMB())  return sizeof(UnalignedNodeMB);
+    else if (node.isQuantizedNode())    return sizeof(QuantizedNode);
+    else return 0;
+  }
+
+  template<int N>
+  size_t BVHNSerializer<N>::allocate(size_t num, size_t align)
+  {
+    static const char padding[nodeAlignment] = { 0 };
+    const size_t ofs = (bytes+align-1) & ~(align-1);
+    if (out) out->write(padding,ofs-bytes);
+    bytes = ofs+num;
+    return ofs;
+  }
+
+  template<int N>
+  size_t BVHNSerializer<N>::serialize(NodeRef node)
+  {
+    if (node.isLeaf())
+    {
+      size_t num; const char* prims = node.leaf(num);
+      if (num == 0) return BVH::emptyNode;
+      const size_t leafBytes = num*bvh->primTy->bytes;
+      const size_t ofs = allocate(leafBytes,BVH::byteAlignment);
+      if (out) out->write(prims,leafBytes);
+      return ofs | (BVH::tyLeaf+num);
+    }
+
+    const size_t size = nodeBytes(node);
+    if (size == 0)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"BVH contains nodes that do not support serialization");
+
+    /* children get stored in front of their parent, thus the node can get written with final references */
+    const BaseNode* n = (const BaseNode*) ((size_t)node & ~BVH::align_mask);
+    size_t children[N];
+    for (size_t i=0; i<N; i++)
+      children[i] = serialize(n->child(i));
+
+    const size_t ofs = allocate(size,nodeAlignment);
+    if (out) {
+      out->write((const char*)children,sizeof(children));
+      out->write((const char*)n+sizeof(children),size-sizeof(children));
+    }
+    return ofs | node.type();
+  }
+
+  template<int N>
+  typename BVHNSerializer<N>::NodeRef BVHNSerializer<N>::relocate(char* base, size_t limit, size_t primBytes, size_t ref)
+  {
+    /* all references point in front of the referencing node, which also rejects cycles in corrupted images */
+    const NodeRef node(ref);
+    const size_t ofs = ref & ~BVH::align_mask;
+    if (node.isLeaf())
+    {
+      const size_t num = (ref & BVH::items_mask)-BVH::tyLeaf;
+      if (num == 0) return BVH::emptyNode;
+      if (ofs+num*primBytes > limit)
+        throw_RTCError(RTC_ERROR_UNKNOWN,"corrupted BVH image");
+      return NodeRef((size_t)base + ref);
+    }
+
+    const size_t size = nodeBytes(node);
+    if (size == 0 || ofs+size > limit)
+      throw_RTCError(RTC_ERROR_UNKNOWN,"corrupted BVH image");
+
+    BaseNode* n = (BaseNode*) (base+ofs);
+    for (size_t i=0; i<N; i++)
+      n->child(i) = relocate(base,ofs,primBytes,n->child(i));
+    return NodeRef((size_t)base + ref);
+  }
+
+#if defined(__AVX__)
+  template class BVHNSerializer<8>;
+#endif
+
+#if !defined(__AVX__) || !defined(EMBREE_TARGET_SSE2) && !defined(EMBREE_TARGET_SSE42)
+  template class BVHNSerializer<4>;
+#endif
+}
@@ -0,0 +1,88 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "bvh.h"
+
+namespace embree
+{
+  /*! Stores a BVH into a relocatable image. All node references of the
+   *  image are stored as offsets relative to the start of the image,
+   *  thus the image can get read or mapped to any 64 byte aligned
+   *  location and gets relocated with a single pass over the nodes. */
+  template<int N>
+  class BVHNSerializer
+  {
+    typedef BVHN<N> BVH;
+    typedef typename BVH::NodeRef NodeRef;
+    typedef typename BVH::BaseNode BaseNode;
+    typedef typename BVH::AlignedNode AlignedNode;
+    typedef typename BVH::AlignedNodeMB AlignedNodeMB;
+    typedef typename BVH::AlignedNodeMB4D AlignedNodeMB4D;
+    typedef typename BVH::UnalignedNode UnalignedNode;
+    typedef typename BVH::UnalignedNodeMB UnalignedNodeMB;
+    typedef typename BVH::QuantizedNode QuantizedNode;
+
+    /*! alignment of nodes inside the image */
+    static const size_t nodeAlignment = 64;
+
+    /*! header stored in front of each image */
+    struct Header
+    {
+      LBBox3fa bounds;        //!< linear bounds of the BVH
+      uint64_t magic;
+      uint32_t type;          //!< type of the acceleration structure
+      uint32_t width;         //!< branching factor
+      char primTy[32];        //!< name of the primitive type
+      uint64_t primBytes;     //!< bytes of a primitive block
+      uint64_t numPrimitives; //!< number of primitives the BVH is build over
+      uint64_t numVertices;   //!< number of vertices the BVH references
+      uint64_t root;          //!< root node as offset into the image
+      uint64_t bytes;         //!< size of the image in bytes
+      uint64_t reserved;
+    };
+
+  public:
+
+    /*! writes the BVH into the stream */
+    static void save(const BVH* bvh, std::ostream& out);
+
+    /*! restores the BVH from the stream, returns false if the image does not match the BVH */
+    static bool load(BVH* bvh, std::istream& in);
+
+  private:
+    BVHNSerializer (const BVH* bvh, std::ostream* out)
+      : bvh(bvh), out(out), bytes(0) {}
+
+    /*! returns the number of bytes of the node, or 0 if the node type is not supported */
+    static size_t nodeBytes(NodeRef node);
+
+    /*! appends the subtree to the image and returns its encoded reference */
+    size_t serialize(NodeRef node);
+
+    /*! reserves aligned space in the image */
+    size_t allocate(size_t num, size_t align);
+
+    /*! converts all references of a subtree of a loaded image into pointers */
+    static NodeRef relocate(char* base, size_t limit, size_t primBytes, size_t ref);
+
+  private:
+    const BVH* bvh;
+    std::ostream* out;
+    size_t bytes;
+  };
+}
@@ -40,6 +40,16 @@ namespace embree
     /*! clears the acceleration structure data */
     virtual void clear() = 0;
 
+    /*! writes the acceleration structure data into a relocatable image */
+    virtual void save(std::ostream& out) const {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"acceleration structure does not support serialization");
+    }
+
+    /*! restores the acceleration structure data from an image, returns false if the image does not match */
+    virtual bool load(std::istream& in) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"acceleration structure does not support serialization");
+    }
+
     /*! returns normal bounds */
     __forceinline BBox3fa getBounds() const {
       return bounds.bounds();
@@ -47,6 +47,17 @@ namespace embree
       if (builder) builder->clear();
     }
 
+    void save(std::ostream& out) const {
+      accel->save(out);
+    }
+
+    bool load(std::istream& in)
+    {
+      if (!accel->load(in)) return false;
+      bounds = accel->bounds;
+      return true;
+    }
+
   private:
     std::unique_ptr<AccelData> accel;
     std::unique_ptr<Builder> builder;
@@ -22,7 +22,7 @@
 namespace embree
 {
   AccelN::AccelN()
-    : Accel(AccelData::TY_ACCELN), accels(nullptr), validAccels(nullptr) {}
+    : Accel(AccelData::TY_ACCELN), accels(nullptr), validAccels(nullptr), sorted(false) {}
 
   AccelN::~AccelN() 
   {
@@ -47,6 +47,18 @@ namespace embree
     accels.clear();
     validAccels.clear();
   }
+
+  void AccelN::take(AccelN& other)
+  {
+    init();
+    sorted = other.sorted;
+    for (size_t i=0; i<other.accels.size(); i++)
+      add(other.accels[i]);
+
+    other.accels.clear();
+    other.validAccels.clear();
+    updateValidAccels();
+  }
   
   void AccelN::intersect (Accel::Intersectors* This_in, RTCRayHit& ray, IntersectContext* context) 
   {
@@ -147,6 +159,129 @@ namespace embree
       This->validAccels[i]->intersectors.occludedN(ray,M,context);
   }
 
+  /*! calculates the distance where a ray enters some bounds, returns inf if the bounds get missed */
+  static __forceinline float clipBounds(const BBox3fa& bounds, const Vec3fa& org, const Vec3fa& dir, const float tnear, const float tfar)
+  {
+    const float round_down = 1.0f-2.0f*float(ulp);
+    const float round_up   = 1.0f+2.0f*float(ulp);
+    const Vec3fa rdir = rcp_safe(dir);
+    const Vec3fa t0 = (bounds.lower-org)*rdir;
+    const Vec3fa t1 = (bounds.upper-org)*rdir;
+    const float tmin = max(reduce_max(min(t0,t1)),tnear)*round_down;
+    const float tmax = min(reduce_min(max(t0,t1)),tfar)*round_up;
+    return tmin <= tmax ? tmin : float(inf);
+  }
+
+  static __forceinline float clipBounds(const BBox3fa& bounds, const RTCRay& ray) {
+    return clipBounds(bounds,Vec3fa(ray.org_x,ray.org_y,ray.org_z),Vec3fa(ray.dir_x,ray.dir_y,ray.dir_z),ray.tnear,ray.tfar);
+  }
+
+  /*! for ray packets the closest entry distance of all active rays gets used */
+  template<int K, typename RayK>
+  static __forceinline float clipBounds(const BBox3fa& bounds, const void* valid, const RayK& ray)
+  {
+    float dist = inf;
+    for (size_t k=0; k<K; k++) {
+      if (((const int*)valid)[k] == 0) continue;
+      dist = min(dist,clipBounds(bounds,Vec3fa(ray.org_x[k],ray.org_y[k],ray.org_z[k]),Vec3fa(ray.dir_x[k],ray.dir_y[k],ray.dir_z[k]),ray.tnear[k],ray.tfar[k]));
+    }
+    return dist;
+  }
+
+  /*! sorts the acceleration structures whose bounds get hit by their entry distance */
+  template<typename Clip>
+  static __forceinline size_t sortAccels(const darray_t<Accel*,16>& accels, const Clip& clip, float* dist, size_t* order)
+  {
+    size_t num = 0;
+    for (size_t i=0; i<accels.size(); i++)
+    {
+      const float d = clip(accels[i]->getBounds());
+      if (d == float(inf)) continue;
+      size_t j = num++;
+      for (; j>0 && dist[j-1] > d; j--) {
+        dist[j] = dist[j-1];
+        order[j] = order[j-1];
+      }
+      dist[j] = d;
+      order[j] = i;
+    }
+    return num;
+  }
+
+  void AccelN::intersectSorted (Accel::Intersectors* This_in, RTCRayHit& ray, IntersectContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    float dist[16]; size_t order[16];
+    const size_t num = sortAccels(This->validAccels,[&] (const BBox3fa& bounds) { return clipBounds(bounds,ray.ray); },dist,order);
+    for (size_t i=0; i<num; i++) {
+      if (dist[i] > ray.ray.tfar) break;
+      This->validAccels[order[i]]->intersectors.intersect(ray,context);
+    }
+  }
+
+  template<int K, typename RayHitK, typename Intersect>
+  static __forceinline void intersectSortedK (const void* valid, AccelN* This, RayHitK& ray, const Intersect& intersect)
+  {
+    float dist[16]; size_t order[16];
+    const size_t num = sortAccels(This->validAccels,[&] (const BBox3fa& bounds) { return clipBounds<K>(bounds,valid,ray.ray); },dist,order);
+    for (size_t i=0; i<num; i++)
+    {
+      /* the hits found so far may have culled the bounds for all rays */
+      Accel* accel = This->validAccels[order[i]];
+      if (clipBounds<K>(accel->getBounds(),valid,ray.ray) == float(inf)) continue;
+      intersect(accel);
+    }
+  }
+
+  void AccelN::intersectSorted4 (const void* valid, Accel::Intersectors* This_in, RTCRayHit4& ray, IntersectContext* context) {
+    intersectSortedK<4>(valid,(AccelN*)This_in->ptr,ray,[&] (Accel* accel) { accel->intersectors.intersect4(valid,ray,context); });
+  }
+
+  void AccelN::intersectSorted8 (const void* valid, Accel::Intersectors* This_in, RTCRayHit8& ray, IntersectContext* context) {
+    intersectSortedK<8>(valid,(AccelN*)This_in->ptr,ray,[&] (Accel* accel) { accel->intersectors.intersect8(valid,ray,context); });
+  }
+
+  void AccelN::intersectSorted16 (const void* valid, Accel::Intersectors* This_in, RTCRayHit16& ray, IntersectContext* context) {
+    intersectSortedK<16>(valid,(AccelN*)This_in->ptr,ray,[&] (Accel* accel) { accel->intersectors.intersect16(valid,ray,context); });
+  }
+
+  void AccelN::occludedSorted (Accel::Intersectors* This_in, RTCRay& ray, IntersectContext* context)
+  {
+    AccelN* This = (AccelN*)This_in->ptr;
+    float dist[16]; size_t order[16];
+    const size_t num = sortAccels(This->validAccels,[&] (const BBox3fa& bounds) { return clipBounds(bounds,ray); },dist,order);
+    for (size_t i=0; i<num; i++) {
+      This->validAccels[order[i]]->intersectors.occluded(ray,context);
+      if (ray.tfar < 0.0f) break;
+    }
+  }
+
+  template<int K, typename RayK, typename Occluded>
+  static __forceinline void occludedSortedK (const void* valid, AccelN* This, RayK& ray, const Occluded& occluded)
+  {
+    float dist[16]; size_t order[16];
+    const size_t num = sortAccels(This->validAccels,[&] (const BBox3fa& bounds) { return clipBounds<K>(bounds,valid,ray); },dist,order);
+    for (size_t i=0; i<num; i++)
+    {
+      /* occluded rays have a negative tfar and thus miss all further bounds */
+      Accel* accel = This->validAccels[order[i]];
+      if (clipBounds<K>(accel->getBounds(),valid,ray) == float(inf)) continue;
+      occluded(accel);
+    }
+  }
+
+  void AccelN::occludedSorted4 (const void* valid, Accel::Intersectors* This_in, RTCRay4& ray, IntersectContext* context) {
+    occludedSortedK<4>(valid,(AccelN*)This_in->ptr,ray,[&] (Accel* accel) { accel->intersectors.occluded4(valid,ray,context); });
+  }
+
+  void AccelN::occludedSorted8 (const void* valid, Accel::Intersectors* This_in, RTCRay8& ray, IntersectContext* context) {
+    occludedSortedK<8>(valid,(AccelN*)This_in->ptr,ray,[&] (Accel* accel) { accel->intersectors.occluded8(valid,ray,context); });
+  }
+
+  void AccelN::occludedSorted16 (const void* valid, Accel::Intersectors* This_in, RTCRay16& ray, IntersectContext* context) {
+    occludedSortedK<16>(valid,(AccelN*)This_in->ptr,ray,[&] (Accel* accel) { accel->intersectors.occluded16(valid,ray,context); });
+  }
+
   void AccelN::print(size_t ident)
   {
     for (size_t i=0; i<validAccels.size(); i++)
@@ -170,6 +305,11 @@ namespace embree
         accels[i]->build();
       });
 
+    updateValidAccels();
+  }
+
+  void AccelN::updateValidAccels()
+  {
     /* create list of non-empty acceleration structures */
     validAccels.clear();
     bool valid1 = true;
@@ -188,6 +328,15 @@ namespace embree
     if (validAccels.size() == 1) {
       intersectors = validAccels[0]->intersectors;
     }
+    else if (sorted)
+    {
+      intersectors.ptr = this;
+      intersectors.intersector1  = Intersector1(&intersectSorted,&occludedSorted,valid1 ? "AccelN::intersectorSorted1": nullptr);
+      intersectors.intersector4  = Intersector4(&intersectSorted4,&occludedSorted4,valid4 ? "AccelN::intersectorSorted4" : nullptr);
+      intersectors.intersector8  = Intersector8(&intersectSorted8,&occludedSorted8,valid8 ? "AccelN::intersectorSorted8" : nullptr);
+      intersectors.intersector16 = Intersector16(&intersectSorted16,&occludedSorted16,valid16 ? "AccelN::intersectorSorted16": nullptr);
+      intersectors.intersectorN  = IntersectorN(&intersectN,&occludedN,"AccelN::intersectorN");
+    }
     else 
     {
       intersectors.ptr = this;
@@ -204,6 +353,27 @@ namespace embree
       bounds.extend(validAccels[i]->bounds);
   }
 
+  void AccelN::save(std::ostream& out) const
+  {
+    const size_t numAccels = accels.size();
+    out.write((const char*)&numAccels,sizeof(numAccels));
+    for (size_t i=0; i<accels.size(); i++)
+      accels[i]->save(out);
+  }
+
+  bool AccelN::load(std::istream& in)
+  {
+    size_t numAccels = 0;
+    in.read((char*)&numAccels,sizeof(numAccels));
+    if (!in || numAccels != accels.size()) return false;
+
+    for (size_t i=0; i<accels.size(); i++)
+      if (!accels[i]->load(in)) return false;
+
+    updateValidAccels();
+    return true;
+  }
+
   void AccelN::select(bool filter)
   {
     for (size_t i=0; i<accels.size(); i++) 
@@ -31,6 +31,9 @@ namespace embree
     void add(Accel* accel);
     void init();
 
+    /*! takes over all acceleration structures of another AccelN */
+    void take(AccelN& other);
+
   public:
     static void intersect (Accel::Intersectors* This, RTCRayHit& ray, IntersectContext* context);
     static void intersect4 (const void* valid, Accel::Intersectors* This, RTCRayHit4& ray, IntersectContext* context);
@@ -45,16 +48,33 @@ namespace embree
     static void occluded16 (const void* valid, Accel::Intersectors* This, RTCRay16& ray, IntersectContext* context);
     static void occludedN (Accel::Intersectors* This, RTCRayN** ray, const size_t N, IntersectContext* context);
 
+  public:
+    /*! front to back traversal of the acceleration structures, skipping those whose bounds get missed */
+    static void intersectSorted (Accel::Intersectors* This, RTCRayHit& ray, IntersectContext* context);
+    static void intersectSorted4 (const void* valid, Accel::Intersectors* This, RTCRayHit4& ray, IntersectContext* context);
+    static void intersectSorted8 (const void* valid, Accel::Intersectors* This, RTCRayHit8& ray, IntersectContext* context);
+    static void intersectSorted16 (const void* valid, Accel::Intersectors* This, RTCRayHit16& ray, IntersectContext* context);
+    static void occludedSorted (Accel::Intersectors* This, RTCRay& ray, IntersectContext* context);
+    static void occludedSorted4 (const void* valid, Accel::Intersectors* This, RTCRay4& ray, IntersectContext* context);
+    static void occludedSorted8 (const void* valid, Accel::Intersectors* This, RTCRay8& ray, IntersectContext* context);
+    static void occludedSorted16 (const void* valid, Accel::Intersectors* This, RTCRay16& ray, IntersectContext* context);
+
   public:
     void print(size_t ident);
     void immutable();
     void build ();
+    void save(std::ostream& out) const;
+    bool load(std::istream& in);
     void select(bool filter);
     void deleteGeometry(size_t geomID);
     void clear ();
 
+  private:
+    void updateValidAccels();
+
   public:
     darray_t<Accel*,16> accels;
     darray_t<Accel*,16> validAccels;
+    bool sorted;  //!< traverses the acceleration structures front to back as children of a single top-level node
   };
 }
@@ -183,7 +183,7 @@ namespace embree
     FastAllocator (Device* device, bool osAllocation) 
       : device(device), slotMask(0), usedBlocks(nullptr), freeBlocks(nullptr), use_single_mode(false), defaultBlockSize(PAGE_SIZE), estimatedSize(0),
         growSize(PAGE_SIZE), maxGrowSize(maxAllocationSize), log2_grow_size_scale(0), bytesUsed(0), bytesFree(0), bytesWasted(0), atype(osAllocation ? OS_MALLOC : ALIGNED_MALLOC),
-        primrefarray(device,0)
+        numaNodes(device && device->alloc_numa_aware ? getNumberOfNUMANodes() : 1), primrefarray(device,0)
     {
       for (size_t i=0; i<MAX_THREAD_USED_BLOCK_SLOTS; i++)
       {
@@ -403,7 +403,7 @@ namespace embree
       slotMask = MAX_THREAD_USED_BLOCK_SLOTS-1; // FIXME: remove
       if (usedBlocks.load() || freeBlocks.load()) { reset(); return; }
       if (bytesReserve == 0) bytesReserve = bytesAllocate;
-      freeBlocks = Block::create(device,bytesAllocate,bytesReserve,nullptr,atype);
+      freeBlocks = Block::create(device,bytesAllocate,bytesReserve,nullptr,atype,-1);
       estimatedSize = bytesEstimate;
       initGrowSizeAndNumSlots(bytesEstimate,true);
     }
@@ -484,6 +484,21 @@ namespace embree
       return size_t(1) << min(size_t(16),scale);
     }
 
+    /*! returns the NUMA node of the calling thread, or -1 if NUMA awareness is disabled */
+    __forceinline int threadNUMANode() const 
+    {
+      if (numaNodes <= 1) return -1;
+      return getCPUTopology(getCurrentCPU()).node;
+    }
+
+    /*! selects the block slot of a thread, threads of different NUMA nodes use different slots if there are enough slots */
+    __forceinline size_t threadSlot(size_t threadID, int node) const
+    {
+      if (node < 0) return threadID & slotMask;
+      const size_t slotsPerNode = max(size_t(1),(slotMask+1)/numaNodes);
+      return (node*slotsPerNode + threadID % slotsPerNode) & slotMask;
+    }
+
     /*! thread safe allocation of memory */
     void* malloc(size_t& bytes, size_t align, bool partial)
     {
@@ -493,7 +508,8 @@ namespace embree
       {
         /* allocate using current block */
         size_t threadID = TaskScheduler::threadID();
-        size_t slot = threadID & slotMask;
+        const int node = threadNUMANode();
+        size_t slot = threadSlot(threadID,node);
 	Block* myUsedBlocks = threadUsedBlocks[slot];
         if (myUsedBlocks) {
           void* ptr = myUsedBlocks->malloc(device,bytes,align,partial);
@@ -512,7 +528,7 @@ namespace embree
             const size_t alignedBytes = (bytes+(align-1)) & ~(align-1);
             const size_t allocSize = max(min(growSize,maxGrowSize),alignedBytes);
             assert(allocSize >= bytes);
-            threadBlocks[slot] = threadUsedBlocks[slot] = Block::create(device,allocSize,allocSize,threadBlocks[slot],atype); // FIXME: a large allocation might throw away a block here!
+            threadBlocks[slot] = threadUsedBlocks[slot] = Block::create(device,allocSize,allocSize,threadBlocks[slot],atype,node); // FIXME: a large allocation might throw away a block here!
             // FIXME: a direct allocation should allocate inside the block here, and not in the next loop! a different thread could do some allocation and make the large allocation fail.
           }
           continue;
@@ -524,15 +540,14 @@ namespace embree
 	  if (myUsedBlocks == threadUsedBlocks[slot])
 	  {
             if (freeBlocks.load() != nullptr) {
-	      Block* nextFreeBlock = freeBlocks.load()->next;
-	      freeBlocks.load()->next = usedBlocks;
+              Block* freeBlock = takeFreeBlock(node);
+	      freeBlock->next = usedBlocks;
 	      __memory_barrier();
-	      usedBlocks = freeBlocks.load();
-              threadUsedBlocks[slot] = freeBlocks.load();
-	      freeBlocks = nextFreeBlock;
+	      usedBlocks = freeBlock;
+              threadUsedBlocks[slot] = freeBlock;
 	    } else {
               const size_t allocSize = min(growSize*incGrowSizeScale(),maxGrowSize);
-	      usedBlocks = threadUsedBlocks[slot] = Block::create(device,allocSize,allocSize,usedBlocks,atype); // FIXME: a large allocation should get delivered directly, like above!
+	      usedBlocks = threadUsedBlocks[slot] = Block::create(device,allocSize,allocSize,usedBlocks,atype,node); // FIXME: a large allocation should get delivered directly, like above!
 	    }
           }
         }
@@ -554,8 +569,19 @@ namespace embree
     /* special allocation only used from morton builder only a single time for each build */
     void* specialAlloc(size_t bytes)
     {
-      assert(freeBlocks.load() != nullptr && freeBlocks.load()->getBlockAllocatedBytes() >= bytes);
-      return freeBlocks.load()->ptr();
+      /* NUMA aware allocation reuses blocks out of order, thus move a large enough block to the front */
+      Block* prev = nullptr;
+      Block* block = freeBlocks.load();
+      while (block && block->getBlockAllocatedBytes() < bytes) {
+        prev = block; block = block->next;
+      }
+      assert(block != nullptr);
+      if (prev) {
+        prev->next = block->next;
+        block->next = freeBlocks.load();
+        freeBlocks = block;
+      }
+      return block->ptr();
     }
 
     struct Statistics
@@ -717,7 +743,7 @@ namespace embree
 
     struct Block
     {
-      static Block* create(MemoryMonitorInterface* device, size_t bytesAllocate, size_t bytesReserve, Block* next, AllocationType atype)
+      static Block* create(MemoryMonitorInterface* device, size_t bytesAllocate, size_t bytesReserve, Block* next, AllocationType atype, int node)
       {
         /* We avoid using os_malloc for small blocks as this could
          * cause a risk of fragmenting the virtual address space and
@@ -753,21 +779,21 @@ namespace embree
             os_advise((void*)(ptr_aligned_begin + 1*PAGE_SIZE_2M),PAGE_SIZE_2M);
             os_advise((void*)(ptr_aligned_begin + 2*PAGE_SIZE_2M),PAGE_SIZE_2M); // may fail if no memory mapped after block
 
-            return new (ptr) Block(ALIGNED_MALLOC,bytesAllocate-sizeof_Header,bytesAllocate-sizeof_Header,next,alignment);
+            return new (ptr) Block(ALIGNED_MALLOC,bytesAllocate-sizeof_Header,bytesAllocate-sizeof_Header,next,alignment,false,node);
           }
           else
           {
             const size_t alignment = maxAlignment;
             if (device) device->memoryMonitor(bytesAllocate+alignment,false);
             ptr = alignedMalloc(bytesAllocate,alignment);
-            return new (ptr) Block(ALIGNED_MALLOC,bytesAllocate-sizeof_Header,bytesAllocate-sizeof_Header,next,alignment);
+            return new (ptr) Block(ALIGNED_MALLOC,bytesAllocate-sizeof_Header,bytesAllocate-sizeof_Header,next,alignment,false,node);
           }
         }
         else if (atype == OS_MALLOC)
         {
           if (device) device->memoryMonitor(bytesAllocate,false);
           bool huge_pages; ptr = os_malloc(bytesReserve,huge_pages);
-          return new (ptr) Block(OS_MALLOC,bytesAllocate-sizeof_Header,bytesReserve-sizeof_Header,next,0,huge_pages);
+          return new (ptr) Block(OS_MALLOC,bytesAllocate-sizeof_Header,bytesReserve-sizeof_Header,next,0,huge_pages,node);
         }
         else
           assert(false);
@@ -775,8 +801,8 @@ namespace embree
         return NULL;
       }
 
-      Block (AllocationType atype, size_t bytesAllocate, size_t bytesReserve, Block* next, size_t wasted, bool huge_pages = false)
-      : cur(0), allocEnd(bytesAllocate), reserveEnd(bytesReserve), next(next), wasted(wasted), atype(atype), huge_pages(huge_pages)
+      Block (AllocationType atype, size_t bytesAllocate, size_t bytesReserve, Block* next, size_t wasted, bool huge_pages = false, int node = -1)
+      : cur(0), allocEnd(bytesAllocate), reserveEnd(bytesReserve), next(next), wasted(wasted), atype(atype), node(node), huge_pages(huge_pages)
       {
         assert((((size_t)&data[0]) & (maxAlignment-1)) == 0);
       }
@@ -937,11 +963,26 @@ namespace embree
       Block* next;               //!< pointer to next block in list
       size_t wasted;             //!< amount of memory wasted through block alignment
       AllocationType atype;      //!< allocation mode of the block
+      int node;                  //!< NUMA node of the thread that created the block, -1 if unknown
       bool huge_pages;           //!< whether the block uses huge pages
-      char align[maxAlignment-5*sizeof(size_t)-sizeof(AllocationType)-sizeof(bool)]; //!< align data to maxAlignment
+      char align[maxAlignment-5*sizeof(size_t)-sizeof(AllocationType)-sizeof(int)-sizeof(bool)]; //!< align data to maxAlignment
       char data[1];              //!< here starts memory to use for allocations
     };
 
+    /*! removes a free block from the free list, blocks first touched by the NUMA node get preferred */
+    __forceinline Block* takeFreeBlock(int node)
+    {
+      Block* block = freeBlocks.load();
+      Block* prev = nullptr;
+      if (node >= 0) {
+        for (Block *b = block, *p = nullptr; b; p = b, b = b->next)
+          if (b->node == node) { block = b; prev = p; break; }
+      }
+      if (prev) prev->next = block->next;
+      else      freeBlocks = block->next;
+      return block;
+    }
+
   private:
     Device* device;
     SpinLock mutex;
@@ -968,6 +1009,7 @@ namespace embree
     SpinLock thread_local_allocators_lock;
     std::vector<ThreadLocal2*> thread_local_allocators;
     AllocationType atype;
+    size_t numaNodes;                  //!< number of NUMA nodes blocks get separated for
     mvector<PrimRef> primrefarray;     //!< primrefarray used to allocate nodes
   };
 }
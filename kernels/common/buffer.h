@@ -158,7 +158,7 @@ namespace embree
       stride = stride_in;
       num = num_in;
       format = format_in;
-      modified = true;
+      setModified(true);
       buffer = buffer_in;
     }
 
@@ -199,6 +199,20 @@ namespace embree
     /*! mark buffer as modified or unmodified */
     __forceinline void setModified(bool b) {
       modified = b;
+      modifiedRanges.clear();
+    }
+
+    /*! marks the elements [begin,end) as modified, too many ranges mark the entire buffer as modified */
+    void setModified(size_t begin, size_t end)
+    {
+      if (begin > end || end > num)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "buffer range out of bounds");
+
+      if (begin == end) return;
+      if (modified && modifiedRanges.empty()) return; // entire buffer is already modified
+      modified = true;
+      if (modifiedRanges.size() >= maxModifiedRanges) modifiedRanges.clear();
+      else modifiedRanges.push_back(range<size_t>(begin,end));
     }
 
     /*! mark buffer as modified or unmodified */
@@ -206,6 +220,16 @@ namespace embree
       return modified;
     }
 
+    /*! returns true if only the modified ranges of the buffer got modified */
+    __forceinline bool isPartiallyModified() const {
+      return modified && !modifiedRanges.empty();
+    }
+
+    /*! returns the modified element ranges, only valid if the buffer is partially modified */
+    __forceinline const std::vector<range<size_t>>& getModifiedRanges() const {
+      return modifiedRanges;
+    }
+
     /*! returns true of the buffer is not empty */
     __forceinline operator bool() const { 
       return ptr_ofs; 
@@ -218,14 +242,35 @@ namespace embree
         volatile int MAYBE_UNUSED w = *((int*)getPtr(size()-1)+3); // FIXME: is failing hard avoidable?
     }
 
+    /*! hashes the first elementBytes bytes of each element, padding bytes are ignored */
+    uint64_t hash(size_t elementBytes, uint64_t h) const
+    {
+      assert(elementBytes % sizeof(unsigned int) == 0);
+      h = hash_combine(h,num);
+      for (size_t i=0; i<num; i++) {
+        const unsigned int* words = (const unsigned int*) getPtr(i);
+        for (size_t j=0; j<elementBytes/sizeof(unsigned int); j++)
+          h = hash_combine(h,words[j]);
+      }
+      return h;
+    }
+
+    /*! combines a hash value with some 64 bit value */
+    static __forceinline uint64_t hash_combine(uint64_t h, uint64_t v) {
+      return (h ^ v) * uint64_t(0x100000001b3); // FNV-1a style mixing
+    }
+
   public:
     char* ptr_ofs;      //!< base pointer plus offset
     size_t stride;      //!< stride of the buffer in bytes
     size_t num;         //!< number of elements in the buffer
     RTCFormat format;   //!< format of the buffer
     bool modified;      //!< true if the buffer got modified
+    std::vector<range<size_t>> modifiedRanges; //!< modified element ranges, empty if the entire buffer got modified
     int userData;       //!< special data
     Ref<Buffer> buffer; //!< reference to the parent buffer
+
+    static const size_t maxModifiedRanges = 64; //!< maximal number of tracked ranges
   };
 
   /*! A typed contiguous range of a buffer. This class does not own the buffer content. */
@@ -26,6 +26,7 @@
 #include "../../common/sys/mutex.h"
 #include "../../common/sys/vector.h"
 #include "../../common/sys/array.h"
+#include "../../common/sys/chunked_vector.h"
 #include "../../common/sys/string.h"
 #include "../../common/sys/regression.h"
 #include "../../common/sys/vector.h"
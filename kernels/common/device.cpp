@@ -50,7 +50,7 @@ namespace embree
   static std::map<Device*,size_t> g_num_threads_map;
 
   Device::Device (const char* cfg, bool singledevice)
-    : State(singledevice)
+    : State(singledevice), numRefitRebuilds(0)
   {
     /* check CPU */
     if (!hasISA(ISA)) 
@@ -118,6 +118,10 @@ namespace embree
 
   Device::~Device ()
   {
+#if defined(TASKING_INTERNAL)
+    if (State::verbosity(2))
+      TaskScheduler::printIdleStatistics();
+#endif
     setCacheSize(0);
     exitTaskingSystem();
   }
@@ -329,16 +333,30 @@ namespace embree
   void Device::initTaskingSystem(size_t numThreads) 
   {
     Lock<MutexSys> lock(g_mutex);
-    if (numThreads == 0) 
-      g_num_threads_map[this] = std::numeric_limits<size_t>::max();
-    else 
-      g_num_threads_map[this] = numThreads;
+    const size_t deviceNumThreads = numThreads == 0 ? std::numeric_limits<size_t>::max() : numThreads;
+
+    /* an isolated device builds with a thread pool of its own, thus does not enlarge the shared thread pool */
+#if defined(TASKING_INTERNAL)
+    g_num_threads_map[this] = State::isolated_threads ? 1 : deviceNumThreads;
+#else
+    g_num_threads_map[this] = deviceNumThreads;
+#endif
 
     /* create task scheduler */
     size_t maxNumThreads = getMaxNumThreads();
     TaskScheduler::create(maxNumThreads,State::set_affinity,State::start_threads);
+#if defined(TASKING_INTERNAL)
+    TaskScheduler::setIdlePolicy((TaskScheduler::IdlePolicy)State::idle_policy);
+    if (State::isolated_threads) {
+      threadPool = make_unique(new TaskScheduler::ThreadPool(State::set_affinity,State::affinity_offset));
+      threadPool->setNumThreads(deviceNumThreads,State::start_threads);
+    }
+#endif
 #if USE_TASK_ARENA
-    arena = make_unique(new tbb::task_arena((int)min(maxNumThreads,TaskScheduler::threadCount())));
+    if (State::isolated_threads)
+      arena = make_unique(new tbb::task_arena((int)min(deviceNumThreads,(size_t)getNumberOfLogicalThreads())));
+    else
+      arena = make_unique(new tbb::task_arena((int)min(maxNumThreads,TaskScheduler::threadCount())));
 #endif
   }
 
@@ -346,6 +364,9 @@ namespace embree
   {
     Lock<MutexSys> lock(g_mutex);
     g_num_threads_map.erase(this);
+#if defined(TASKING_INTERNAL)
+    threadPool.reset();
+#endif
 
     /* terminate tasking system */
     if (g_num_threads_map.size() == 0) {
@@ -501,6 +522,8 @@ namespace embree
     case RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED: return 1;
 #endif
 
+    case RTC_DEVICE_PROPERTY_REFIT_REBUILD_COUNT: return numRefitRebuilds;
+
     default: throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown readable property"); break;
     };
   }
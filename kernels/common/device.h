@@ -92,11 +92,17 @@ namespace embree
     std::unique_ptr<BVH8Factory> bvh8_factory;
 #endif
     
+#if defined(TASKING_INTERNAL)
+    std::unique_ptr<TaskScheduler::ThreadPool> threadPool; //!< worker threads of isolated devices, null when sharing the global thread pool
+#endif
+
 #if USE_TASK_ARENA
     std::unique_ptr<tbb::task_arena> arena;
 #endif
     
     /* ray streams filter */
     RayStreamFilterFuncs rayStreamFilters;
+
+    std::atomic<size_t> numRefitRebuilds; //!< number of refitted BVHs that got rebuilt because of degraded quality
   };
 }
@@ -142,6 +142,11 @@ namespace embree
     virtual void updateBuffer(RTCBufferType type, unsigned int slot) {
       update(); // update everything for geometries not supporting this call
     }
+
+    /*! Update range of geometry buffer. */
+    virtual void updateBufferRange(RTCBufferType type, unsigned int slot, size_t begin, size_t count) {
+      updateBuffer(type,slot); // update entire buffer for geometries not supporting this call
+    }
     
     /*! Disable geometry. */
     virtual void disable();
@@ -149,6 +154,11 @@ namespace embree
     /*! Verify the geometry */
     virtual bool verify() { return true; }
 
+    /*! calculates a hash over all geometry data the acceleration structure depends on */
+    virtual uint64_t hash() const {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry");
+    }
+
     /*! called if geometry is switching from disabled to enabled state */
     virtual void enabling() = 0;
 
@@ -28,6 +28,7 @@
 
 #include "../builders/bvh_builder_sah.h"
 #include "../builders/bvh_builder_morton.h"
+#include "../builders/bvh_builder_ploc.h"
 
 namespace embree
 { 
@@ -63,22 +64,9 @@ namespace embree
       return nullptr;
     }
 
-    void* rtcBuildBVHMorton(const RTCBuildArguments* arguments)
+    /* initializes the temporary arrays of the morton and PLOC builders with the morton codes of all primitives */
+    void computeMortonCodes(BVH* bvh, const PrimRef* prims, size_t primitiveCount)
     {
-      BVH* bvh = (BVH*) arguments->bvh;
-      RTCBuildPrimitive* prims_i =  arguments->primitives;
-      size_t primitiveCount = arguments->primitiveCount;
-      RTCCreateNodeFunction createNode = arguments->createNode;
-      RTCSetNodeChildrenFunction setNodeChildren = arguments->setNodeChildren;
-      RTCSetNodeBoundsFunction setNodeBounds = arguments->setNodeBounds;
-      RTCCreateLeafFunction createLeaf = arguments->createLeaf;
-      RTCProgressMonitorFunction buildProgress = arguments->buildProgress;
-      void* userPtr = arguments->userPtr;
-        
-      std::atomic<size_t> progress(0);
-      
-      /* initialize temporary arrays for morton builder */
-      PrimRef* prims = (PrimRef*) prims_i;
       mvector<BVHBuilderMorton::BuildPrim>& morton_src = bvh->morton_src;
       mvector<BVHBuilderMorton::BuildPrim>& morton_tmp = bvh->morton_tmp;
       morton_src.resize(primitiveCount);
@@ -101,6 +89,27 @@ namespace embree
             generator(prims[i].bounds(),(unsigned) i);
           }
         });
+    }
+
+    void* rtcBuildBVHMorton(const RTCBuildArguments* arguments)
+    {
+      BVH* bvh = (BVH*) arguments->bvh;
+      RTCBuildPrimitive* prims_i =  arguments->primitives;
+      size_t primitiveCount = arguments->primitiveCount;
+      RTCCreateNodeFunction createNode = arguments->createNode;
+      RTCSetNodeChildrenFunction setNodeChildren = arguments->setNodeChildren;
+      RTCSetNodeBoundsFunction setNodeBounds = arguments->setNodeBounds;
+      RTCCreateLeafFunction createLeaf = arguments->createLeaf;
+      RTCProgressMonitorFunction buildProgress = arguments->buildProgress;
+      void* userPtr = arguments->userPtr;
+        
+      std::atomic<size_t> progress(0);
+      
+      /* initialize temporary arrays for morton builder */
+      PrimRef* prims = (PrimRef*) prims_i;
+      computeMortonCodes(bvh,prims,primitiveCount);
+      mvector<BVHBuilderMorton::BuildPrim>& morton_src = bvh->morton_src;
+      mvector<BVHBuilderMorton::BuildPrim>& morton_tmp = bvh->morton_tmp;
 
       /* start morton build */
       std::pair<void*,BBox3fa> root = BVHBuilderMorton::build<std::pair<void*,BBox3fa>>(
@@ -160,6 +169,96 @@ namespace embree
       return root.first;
     }
 
+    void* rtcBuildBVHPLOC(const RTCBuildArguments* arguments)
+    {
+      BVH* bvh = (BVH*) arguments->bvh;
+      RTCBuildPrimitive* prims_i =  arguments->primitives;
+      size_t primitiveCount = arguments->primitiveCount;
+      RTCCreateNodeFunction createNode = arguments->createNode;
+      RTCSetNodeChildrenFunction setNodeChildren = arguments->setNodeChildren;
+      RTCSetNodeBoundsFunction setNodeBounds = arguments->setNodeBounds;
+      RTCCreateLeafFunction createLeaf = arguments->createLeaf;
+      RTCProgressMonitorFunction buildProgress = arguments->buildProgress;
+      void* userPtr = arguments->userPtr;
+        
+      std::atomic<size_t> progress(0);
+      
+      /* the PLOC builder starts from morton ordered primitives */
+      PrimRef* prims = (PrimRef*) prims_i;
+      computeMortonCodes(bvh,prims,primitiveCount);
+      mvector<BVHBuilderMorton::BuildPrim>& morton_src = bvh->morton_src;
+      mvector<BVHBuilderMorton::BuildPrim>& morton_tmp = bvh->morton_tmp;
+
+      /* start PLOC build */
+      std::pair<void*,BBox3fa> root = BVHBuilderPLOC::build<std::pair<void*,BBox3fa>>(
+        
+        /* thread local allocator for fast allocations */
+        [&] () -> FastAllocator::CachedAllocator { 
+          return bvh->allocator.getCachedAllocator();
+        },
+        
+        /* lambda function that allocates BVH nodes */
+        [&] ( const FastAllocator::CachedAllocator& alloc, size_t N ) -> void* {
+          return createNode((RTCThreadLocalAllocator)&alloc, (unsigned int)N,userPtr);
+        },
+        
+        /* lambda function that sets bounds */
+        [&] (void* node, const std::pair<void*,BBox3fa>* children, size_t N) -> std::pair<void*,BBox3fa>
+        {
+          BBox3fa bounds = empty;
+          void* childptrs[BVHBuilderPLOC::MAX_BRANCHING_FACTOR];
+          const RTCBounds* cbounds[BVHBuilderPLOC::MAX_BRANCHING_FACTOR];
+          for (size_t i=0; i<N; i++) {
+            bounds.extend(children[i].second);
+            childptrs[i] = children[i].first;
+            cbounds[i] = (const RTCBounds*)&children[i].second;
+          }
+          setNodeBounds(node,cbounds,(unsigned int)N,userPtr);
+          setNodeChildren(node,childptrs, (unsigned int)N,userPtr);
+          return std::make_pair(node,bounds);
+        },
+        
+        /* lambda function that creates BVH leaves, the clustering reorders primitives, thus we gather them for the leaf */
+        [&]( const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc) -> std::pair<void*,BBox3fa>
+        {
+          RTCBuildPrimitive static_leafPrims[16];
+          std::vector<RTCBuildPrimitive> dynamic_leafPrims;
+          RTCBuildPrimitive* leafPrims = static_leafPrims;
+          if (current.size() > 16) {
+            dynamic_leafPrims.resize(current.size());
+            leafPrims = dynamic_leafPrims.data();
+          }
+
+          BBox3fa bounds = empty;
+          for (size_t i=0; i<current.size(); i++) {
+            const size_t id = morton_src[current.begin()+i].index;
+            leafPrims[i] = prims_i[id];
+            bounds.extend(prims[id].bounds());
+          }
+          void* node = createLeaf((RTCThreadLocalAllocator)&alloc,leafPrims,current.size(),userPtr);
+          return std::make_pair(node,bounds);
+        },
+        
+        /* lambda that calculates the bounds for some primitive */
+        [&] (const BVHBuilderMorton::BuildPrim& morton) -> BBox3fa {
+          return prims[morton.index].bounds();
+        },
+        
+        /* progress monitor function */
+        [&] (size_t dn) {
+          if (!buildProgress) return true;
+          const size_t n = progress.fetch_add(dn)+dn;
+          const double f = std::min(1.0,double(n)/double(primitiveCount));
+          return buildProgress(userPtr,f);
+        },
+        
+        morton_src.data(),morton_tmp.data(),primitiveCount,
+        BVHBuilderPLOC::Settings(*arguments));
+
+      bvh->allocator.cleanup();
+      return root.first;
+    }
+
     void* rtcBuildBVHBinnedSAH(const RTCBuildArguments* arguments)
     {
       BVH* bvh = (BVH*) arguments->bvh;
@@ -356,8 +455,12 @@ namespace embree
       /* switch between differnet builders based on quality level */
       if (arguments->buildQuality == RTC_BUILD_QUALITY_LOW)
         return rtcBuildBVHMorton(arguments);
-      else if (arguments->buildQuality == RTC_BUILD_QUALITY_MEDIUM)
-        return rtcBuildBVHBinnedSAH(arguments);
+      else if (arguments->buildQuality == RTC_BUILD_QUALITY_MEDIUM) {
+        if (arguments->buildFlags & RTC_BUILD_FLAG_CLUSTERING)
+          return rtcBuildBVHPLOC(arguments);
+        else
+          return rtcBuildBVHBinnedSAH(arguments);
+      }
       else if (arguments->buildQuality == RTC_BUILD_QUALITY_HIGH) {
         if (arguments->splitPrimitive == nullptr || arguments->primitiveArrayCapacity <= arguments->primitiveCount)
           return rtcBuildBVHBinnedSAH(arguments);
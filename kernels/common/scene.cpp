@@ -29,6 +29,69 @@ namespace embree
   void invalid_rtcIntersect16() { throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcIntersect16 and rtcOccluded16 not enabled"); }
   void invalid_rtcIntersectN()  { throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcIntersectN and rtcOccludedN not enabled"); }
 
+  /* ray queries of scenes with asynchronous commits are forwarded to the last published version */
+  __forceinline Accel::Intersectors& published(Accel::Intersectors* This) {
+    return ((Scene*)This->ptr)->publishedAccels.load()->intersectors;
+  }
+
+  void intersectPublished (Accel::Intersectors* This, RTCRayHit& ray, IntersectContext* context) {
+    published(This).intersect(ray,context);
+  }
+
+  void intersectPublished4 (const void* valid, Accel::Intersectors* This, RTCRayHit4& ray, IntersectContext* context)
+  {
+    Accel::Intersectors& intersectors = published(This);
+    if (likely(intersectors.intersector4)) intersectors.intersect4(valid,ray,context);
+    else ((Scene*)This->ptr)->device->rayStreamFilters.intersectSOA((Scene*)This->ptr,(char*)&ray,4,1,sizeof(RTCRayHit4),context);
+  }
+
+  void intersectPublished8 (const void* valid, Accel::Intersectors* This, RTCRayHit8& ray, IntersectContext* context)
+  {
+    Accel::Intersectors& intersectors = published(This);
+    if (likely(intersectors.intersector8)) intersectors.intersect8(valid,ray,context);
+    else ((Scene*)This->ptr)->device->rayStreamFilters.intersectSOA((Scene*)This->ptr,(char*)&ray,8,1,sizeof(RTCRayHit8),context);
+  }
+
+  void intersectPublished16 (const void* valid, Accel::Intersectors* This, RTCRayHit16& ray, IntersectContext* context)
+  {
+    Accel::Intersectors& intersectors = published(This);
+    if (likely(intersectors.intersector16)) intersectors.intersect16(valid,ray,context);
+    else ((Scene*)This->ptr)->device->rayStreamFilters.intersectSOA((Scene*)This->ptr,(char*)&ray,16,1,sizeof(RTCRayHit16),context);
+  }
+
+  void intersectPublishedN (Accel::Intersectors* This, RTCRayHitN** ray, const size_t N, IntersectContext* context) {
+    published(This).intersectN(ray,N,context);
+  }
+
+  void occludedPublished (Accel::Intersectors* This, RTCRay& ray, IntersectContext* context) {
+    published(This).occluded(ray,context);
+  }
+
+  void occludedPublished4 (const void* valid, Accel::Intersectors* This, RTCRay4& ray, IntersectContext* context)
+  {
+    Accel::Intersectors& intersectors = published(This);
+    if (likely(intersectors.intersector4)) intersectors.occluded4(valid,ray,context);
+    else ((Scene*)This->ptr)->device->rayStreamFilters.occludedSOA((Scene*)This->ptr,(char*)&ray,4,1,sizeof(RTCRay4),context);
+  }
+
+  void occludedPublished8 (const void* valid, Accel::Intersectors* This, RTCRay8& ray, IntersectContext* context)
+  {
+    Accel::Intersectors& intersectors = published(This);
+    if (likely(intersectors.intersector8)) intersectors.occluded8(valid,ray,context);
+    else ((Scene*)This->ptr)->device->rayStreamFilters.occludedSOA((Scene*)This->ptr,(char*)&ray,8,1,sizeof(RTCRay8),context);
+  }
+
+  void occludedPublished16 (const void* valid, Accel::Intersectors* This, RTCRay16& ray, IntersectContext* context)
+  {
+    Accel::Intersectors& intersectors = published(This);
+    if (likely(intersectors.intersector16)) intersectors.occluded16(valid,ray,context);
+    else ((Scene*)This->ptr)->device->rayStreamFilters.occludedSOA((Scene*)This->ptr,(char*)&ray,16,1,sizeof(RTCRay16),context);
+  }
+
+  void occludedPublishedN (Accel::Intersectors* This, RTCRayN** ray, const size_t N, IntersectContext* context) {
+    published(This).occludedN(ray,N,context);
+  }
+
   Scene::Scene (Device* device)
     : Accel(AccelData::TY_UNKNOWN),
       device(device),
@@ -36,6 +99,7 @@ namespace embree
       scene_flags(RTC_SCENE_FLAG_NONE),
       quality_flags(RTC_BUILD_QUALITY_MEDIUM),
       is_build(false), modified(true),
+      publishedAccels(nullptr), retiredAccels(nullptr), commit_thread(nullptr), commit_function(nullptr), commit_ptr(nullptr), commit_preview(false), preview_build(false),
       progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0), 
       numIntersectionFiltersN(0)
   {
@@ -50,6 +114,7 @@ namespace embree
 #endif
 
     intersectors = Accel::Intersectors(missing_rtcCommit);
+    accels.sorted = device->unified_top_level;
 
     /* one can overwrite flags through device for debugging */
     if (device->quality_flags != -1)
@@ -60,14 +125,19 @@ namespace embree
 
   Scene::~Scene () 
   {
+    /* a pending asynchronous commit still references this scene */
+    waitCommit();
+    delete retiredAccels;
+    delete publishedAccels.load();
+
 #if defined(TASKING_TBB) || defined(TASKING_PPL)
     delete group; group = nullptr;
 #endif
 
     /* detach all geometries */
-    for (auto& geometry : geometries)
-      if (geometry)
-        geometry->detach();
+    for (size_t i=0; i<geometries.size(); i++)
+      if (geometries[i])
+        geometries[i]->detach();
 
     device->refDec();
   }
@@ -130,7 +200,32 @@ namespace embree
 #if defined(EMBREE_GEOMETRY_TRIANGLE)
     if (device->tri_accel == "default") 
     {
-      if (quality_flags != RTC_BUILD_QUALITY_LOW)
+      if (preview_build) /* preview of progressive commit */
+      {
+#if defined (EMBREE_TARGET_SIMD8)
+          if (device->hasISA(AVX))
+	  {
+            int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel();
+            switch (mode) {
+            case /*0b00*/ 0: accels.add(device->bvh8_factory->BVH8Triangle4 (this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::FAST  )); break;
+            case /*0b01*/ 1: accels.add(device->bvh8_factory->BVH8Triangle4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::ROBUST)); break;
+            case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4i(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::FAST  )); break;
+            case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4i(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::ROBUST)); break;
+            }
+          }
+          else
+#endif
+          {
+            int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel();
+            switch (mode) {
+            case /*0b00*/ 0: accels.add(device->bvh4_factory->BVH4Triangle4 (this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::FAST  )); break;
+            case /*0b01*/ 1: accels.add(device->bvh4_factory->BVH4Triangle4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::ROBUST)); break;
+            case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4i(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::FAST  )); break;
+            case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4i(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::ROBUST)); break;
+            }
+          }
+      }
+      else if (quality_flags != RTC_BUILD_QUALITY_LOW)
       {
         int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel(); 
         switch (mode) {
@@ -214,13 +309,15 @@ namespace embree
     if (device->tri_accel_mb == "default")
     {
       int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel(); 
+      BVHFactory::BuildVariant bvariant = BVHFactory::BuildVariant::STATIC;
+      if (quality_flags == RTC_BUILD_QUALITY_HIGH) bvariant = BVHFactory::BuildVariant::HIGH_QUALITY;
       
 #if defined (EMBREE_TARGET_SIMD8)
       if (device->hasISA(AVX2)) // BVH8 reduces performance on AVX only-machines
       {
         switch (mode) {
-        case /*0b00*/ 0: accels.add(device->bvh8_factory->BVH8Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b01*/ 1: accels.add(device->bvh8_factory->BVH8Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b00*/ 0: accels.add(device->bvh8_factory->BVH8Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b01*/ 1: accels.add(device->bvh8_factory->BVH8Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
         case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
         case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
         }
@@ -229,8 +326,8 @@ namespace embree
 #endif
       {
         switch (mode) {
-        case /*0b00*/ 0: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
-        case /*0b01*/ 1: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
+        case /*0b00*/ 0: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST  )); break;
+        case /*0b01*/ 1: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST)); break;
         case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
         case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Triangle4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST)); break;
         }
@@ -251,7 +348,32 @@ namespace embree
 #if defined(EMBREE_GEOMETRY_QUAD)
     if (device->quad_accel == "default") 
     {
-      if (quality_flags != RTC_BUILD_QUALITY_LOW)
+      if (preview_build) /* preview of progressive commit */
+      {
+#if defined (EMBREE_TARGET_SIMD8)
+          if (device->hasISA(AVX))
+	  {
+            int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel();
+            switch (mode) {
+            case /*0b00*/ 0: accels.add(device->bvh8_factory->BVH8Quad4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::FAST)); break;
+            case /*0b01*/ 1: accels.add(device->bvh8_factory->BVH8Quad4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::ROBUST)); break;
+            case /*0b10*/ 2: accels.add(device->bvh8_factory->BVH8Quad4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::FAST)); break;
+            case /*0b11*/ 3: accels.add(device->bvh8_factory->BVH8Quad4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::ROBUST)); break;
+            }
+          }
+          else
+#endif
+          {
+            int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel();
+            switch (mode) {
+            case /*0b00*/ 0: accels.add(device->bvh4_factory->BVH4Quad4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::FAST)); break;
+            case /*0b01*/ 1: accels.add(device->bvh4_factory->BVH4Quad4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::ROBUST)); break;
+            case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Quad4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::FAST)); break;
+            case /*0b11*/ 3: accels.add(device->bvh4_factory->BVH4Quad4v(this,BVHFactory::BuildVariant::MORTON,BVHFactory::IntersectVariant::ROBUST)); break;
+            }
+          }
+      }
+      else if (quality_flags != RTC_BUILD_QUALITY_LOW)
       {
         /* static */
         int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel(); 
@@ -333,23 +455,25 @@ namespace embree
     if (device->quad_accel_mb == "default") 
     {
       int mode =  2*(int)isCompactAccel() + 1*(int)isRobustAccel(); 
+      BVHFactory::BuildVariant bvariant = BVHFactory::BuildVariant::STATIC;
+      if (quality_flags == RTC_BUILD_QUALITY_HIGH) bvariant = BVHFactory::BuildVariant::HIGH_QUALITY;
       switch (mode) {
       case /*0b00*/ 0:
 #if defined (EMBREE_TARGET_SIMD8)
         if (device->hasISA(AVX))
-          accels.add(device->bvh8_factory->BVH8Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
+          accels.add(device->bvh8_factory->BVH8Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST));
         else
 #endif
-          accels.add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST));
+          accels.add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::FAST));
         break;
 
       case /*0b01*/ 1:
 #if defined (EMBREE_TARGET_SIMD8)
         if (device->hasISA(AVX))
-          accels.add(device->bvh8_factory->BVH8Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST));
+          accels.add(device->bvh8_factory->BVH8Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST));
         else
 #endif
-          accels.add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::ROBUST));
+          accels.add(device->bvh4_factory->BVH4Quad4iMB(this,bvariant,BVHFactory::IntersectVariant::ROBUST));
         break;
 
       case /*0b10*/ 2: accels.add(device->bvh4_factory->BVH4Quad4iMB(this,BVHFactory::BuildVariant::STATIC,BVHFactory::IntersectVariant::FAST  )); break;
@@ -587,14 +711,36 @@ namespace embree
       if (!id_pool.add(geomID))
         throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid geometry ID provided");
     }
-    if (geomID >= geometries.size()) {
-      geometries.resize(geomID+1);
-      vertices.resize(geomID+1);
-    }
+    geometries.grow(geomID+1);
     geometries[geomID] = geometry->attach(this,geomID);
     return geomID;
   }
 
+  unsigned Scene::reserveGeometryIDs(unsigned num)
+  {
+    const unsigned firstGeomID = id_pool.allocateRange(num);
+    if (firstGeomID == RTC_INVALID_GEOMETRY_ID)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"too many geometries inside scene");
+    geometries.grow(size_t(firstGeomID)+num);
+    return firstGeomID;
+  }
+
+  void Scene::bind(unsigned firstGeomID, Ref<Geometry>* geoms, unsigned num)
+  {
+    if (size_t(firstGeomID)+num > geometries.size())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid geometry ID provided");
+
+    for (unsigned i=0; i<num; i++) {
+      if (geometries[firstGeomID+i] != null)
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid geometry ID provided");
+    }
+    
+    for (unsigned i=0; i<num; i++) {
+      const unsigned geomID = firstGeomID+i;
+      geometries[geomID] = geoms[i]->attach(this,geomID);
+    }
+  }
+
   void Scene::detachGeometry(size_t geomID)
   {
     Lock<SpinLock> lock(geometriesMutex);
@@ -610,15 +756,49 @@ namespace embree
     accels.deleteGeometry(unsigned(geomID));
     id_pool.deallocate((unsigned)geomID);
     geometries[geomID] = null;
-    vertices[geomID] = nullptr;
+    if (geomID < vertices.size()) vertices[geomID] = nullptr;
   }
 
   void Scene::updateInterface()
   {
     /* update bounds */
     is_build = true;
+
+    /* scenes with asynchronous commits keep using the last published version, even if a build failed */
+    if (hasAsyncCommit())
+      return;
+
     bounds = accels.bounds;
     intersectors = accels.intersectors;
+
+    /* release versions left over from asynchronous commits */
+    delete retiredAccels; retiredAccels = nullptr;
+    delete publishedAccels.exchange(nullptr);
+  }
+
+  void Scene::publishAccels()
+  {
+    /* the build slot gets re-created for the next commit, thus published versions are never modified again */
+    AccelN* version = new AccelN;
+    version->take(accels);
+
+    /* ray queries issued before the previous publish have finished by now */
+    delete retiredAccels;
+    retiredAccels = publishedAccels.exchange(version);
+    bounds = version->bounds;
+
+    /* the forwarding intersectors stay the same for all versions */
+    if (intersectors.ptr != this)
+    {
+      Accel::Intersectors forward;
+      forward.ptr = this;
+      forward.intersector1  = Intersector1 (&intersectPublished  ,&occludedPublished  ,"Scene::intersector1");
+      forward.intersector4  = Intersector4 (&intersectPublished4 ,&occludedPublished4 ,"Scene::intersector4");
+      forward.intersector8  = Intersector8 (&intersectPublished8 ,&occludedPublished8 ,"Scene::intersector8");
+      forward.intersector16 = Intersector16(&intersectPublished16,&occludedPublished16,"Scene::intersector16");
+      forward.intersectorN  = IntersectorN (&intersectPublishedN ,&occludedPublishedN ,"Scene::intersectorN");
+      intersectors = forward;
+    }
   }
 
   void Scene::commit_task ()
@@ -627,8 +807,22 @@ namespace embree
     if (device->verbosity(2))
       printStatistics();
 
+    beginCommit();
+  
+    /* build all hierarchies of this scene */
+    accels.build();
+
+    finishCommit();
+  }
+
+  void Scene::beginCommit()
+  {
     progress_monitor_counter = 0;
 
+    /* geometries get attached without resizing the vertex pointer array */
+    for (size_t i=vertices.size(), N=geometries.size(); i<N; i++)
+      vertices.push_back(nullptr);
+
     /* call preCommit function of each geometry */
     parallel_for(geometries.size(), [&] ( const size_t i ) {
         if (geometries[i] && geometries[i]->isEnabled())
@@ -662,12 +856,12 @@ namespace embree
     
     /* select fast code path if no filter function is present */
     accels.select(hasFilterFunction());
-  
-    /* build all hierarchies of this scene */
-    accels.build();
+  }
 
-    /* make static geometry immutable */
-    if (!isDynamicAccel()) {
+  void Scene::finishCommit()
+  {
+    /* make static geometry immutable, published versions are immutable too */
+    if (!isDynamicAccel() || hasAsyncCommit()) {
       accels.immutable();
       flags_modified = true; // in non-dynamic mode we have to re-create accels
     }
@@ -677,12 +871,16 @@ namespace embree
         if (geometries[i] && geometries[i]->isEnabled())
           geometries[i]->postCommit();
       });
+
+    if (hasAsyncCommit())
+      publishAccels();
       
     updateInterface();
 
     if (device->verbosity(2)) {
       std::cout << "created scene intersector" << std::endl;
-      accels.print(2);
+      if (hasAsyncCommit()) publishedAccels.load()->print(2);
+      else                  accels.print(2);
       std::cout << "selected scene intersector" << std::endl;
       intersectors.print(2);
     }
@@ -690,6 +888,76 @@ namespace embree
     setModified(false);
   }
 
+  /*! identifies a scene BVH image */
+  static const uint64_t SCENE_IMAGE_MAGIC = 0x31454e4543534245; // "EBSCENE1"
+
+  uint64_t Scene::geometryHash()
+  {
+    std::vector<uint64_t> hashes(geometries.size(),0);
+    parallel_for(geometries.size(), [&] ( const size_t i ) {
+        if (geometries[i] && geometries[i]->isEnabled())
+          hashes[i] = geometries[i]->hash();
+      });
+
+    uint64_t h = geometries.size();
+    for (size_t i=0; i<hashes.size(); i++)
+      h = RawBufferView::hash_combine(h,hashes[i]);
+    return h;
+  }
+
+  void Scene::saveBVH(const std::string& fileName)
+  {
+    Lock<MutexSys> lock(buildMutex);
+    if (isModified())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got not committed");
+    if (isDynamicAccel())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"BVH images are only supported for static scenes");
+
+    const uint64_t header[2] = { SCENE_IMAGE_MAGIC, geometryHash() };
+
+    std::ofstream out(fileName.c_str(),std::ios::binary);
+    if (!out) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"cannot open file " + fileName);
+    out.write((const char*)header,sizeof(header));
+    if (hasAsyncCommit()) publishedAccels.load()->save(out);
+    else                  accels.save(out);
+    if (!out) throw_RTCError(RTC_ERROR_UNKNOWN,"error writing file " + fileName);
+  }
+
+  bool Scene::loadBVH(const std::string& fileName)
+  {
+    Lock<MutexSys> lock(buildMutex);
+    if (isDynamicAccel())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"BVH images are only supported for static scenes");
+
+    std::ifstream in(fileName.c_str(),std::ios::binary);
+    if (!in) return false;
+
+    /* the image is only valid for unchanged geometry data */
+    uint64_t header[2];
+    in.read((char*)header,sizeof(header));
+    if (!in || header[0] != SCENE_IMAGE_MAGIC || header[1] != geometryHash())
+      return false;
+
+    beginCommit();
+
+    /* load all hierarchies of this scene */
+    try {
+      if (!accels.load(in)) {
+        accels.clear();
+        updateInterface();
+        return false;
+      }
+    }
+    catch (...) {
+      accels.clear();
+      updateInterface();
+      throw;
+    }
+
+    finishCommit();
+    return true;
+  }
+
   void Scene::setBuildQuality(RTCBuildQuality quality_flags_i)
   {
     if (quality_flags == quality_flags_i) return;
@@ -725,7 +993,7 @@ namespace embree
       scheduler = this->scheduler;
       if (scheduler == null) {
         buildLock.lock();
-        this->scheduler = scheduler = new TaskScheduler;
+        this->scheduler = scheduler = new TaskScheduler(device->threadPool.get());
       }
     }
 
@@ -851,6 +1119,237 @@ namespace embree
   }
 #endif
 
+  void Scene::commitScenes (Scene** scenes_in, size_t numScenes)
+  {
+    /* progressive commits get handled individually after all other scenes got built */
+    std::vector<Scene*> scenes, progressiveScenes;
+    std::map<Scene*,size_t> sceneIndex;
+    for (size_t i=0; i<numScenes; i++)
+    {
+      Scene* scene = scenes_in[i];
+      if (scene == nullptr)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid scene");
+      if (scene->device != scenes_in[0]->device)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"scenes belong to different devices");
+      if (scene->hasProgressiveCommit()) {
+        if (std::find(progressiveScenes.begin(),progressiveScenes.end(),scene) == progressiveScenes.end())
+          progressiveScenes.push_back(scene);
+        continue;
+      }
+      if (sceneIndex.find(scene) != sceneIndex.end())
+        continue;
+      sceneIndex[scene] = scenes.size();
+      scenes.push_back(scene);
+    }
+
+    /* the level of a scene is one above the levels of all scenes of the batch it instances */
+    std::vector<std::vector<size_t>> children(scenes.size());
+    for (size_t i=0; i<scenes.size(); i++)
+    {
+      Scene* scene = scenes[i];
+      for (size_t geomID=0; geomID<scene->size(); geomID++)
+      {
+        /* instances are user geometries, thus we have to identify them by their class */
+        Instance* instance = dynamic_cast<Instance*>(scene->get(geomID));
+        if (instance == nullptr) continue;
+        auto child = sceneIndex.find(instance->object);
+        if (child != sceneIndex.end())
+          children[i].push_back(child->second);
+      }
+    }
+
+    std::vector<size_t> level(scenes.size(),size_t(-1));
+    std::function<size_t(size_t,size_t)> calculateLevel = [&] (size_t i, size_t depth) -> size_t
+    {
+      if (level[i] != size_t(-1)) return level[i];
+      if (depth > scenes.size())
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"scenes instance each other recursively");
+      size_t l = 0;
+      for (size_t child : children[i])
+        l = max(l,calculateLevel(child,depth+1)+1);
+      return level[i] = l;
+    };
+    std::vector<std::vector<size_t>> levels;
+    for (size_t i=0; i<scenes.size(); i++) {
+      const size_t l = calculateLevel(i,0);
+      if (l >= levels.size()) levels.resize(l+1);
+    }
+
+    /* lock all scenes, committing a scene of the batch from another thread has to wait until the batch finished */
+    for (auto scene : scenes) scene->waitCommit();
+#if defined(TASKING_INTERNAL)
+    Ref<TaskScheduler> scheduler = new TaskScheduler(scenes_in[0]->device->threadPool.get());
+#endif
+    size_t numLocked = 0;
+    auto unlock = [&] ()
+    {
+      for (size_t i=0; i<numLocked; i++) {
+#if defined(TASKING_INTERNAL)
+        Lock<MutexSys> lock(scenes[i]->schedulerMutex);
+        scenes[i]->scheduler = nullptr;
+#endif
+        scenes[i]->buildMutex.unlock();
+      }
+    };
+    for (; numLocked<scenes.size(); numLocked++)
+    {
+      Scene* scene = scenes[numLocked];
+      bool locked = false;
+#if defined(TASKING_INTERNAL)
+      {
+        Lock<MutexSys> lock(scene->schedulerMutex);
+        if (scene->scheduler == null && scene->buildMutex.try_lock()) {
+          scene->scheduler = scheduler;
+          locked = true;
+        }
+      }
+#else
+      locked = scene->buildMutex.try_lock();
+#endif
+      if (!locked) {
+        unlock();
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene is already getting committed");
+      }
+    }
+
+    /* only modified scenes get built */
+    for (size_t i=0; i<scenes.size(); i++)
+      if (scenes[i]->isModified())
+        levels[level[i]].push_back(i);
+
+    /* all scenes of a level get built in parallel, the builds themselves spawn further tasks */
+    std::vector<char> built(scenes.size(),false);
+    auto build = [&] ()
+    {
+      for (auto& scenesOfLevel : levels)
+      {
+        parallel_for(scenesOfLevel.size(), [&] (size_t i) {
+            scenes[scenesOfLevel[i]]->commit_task();
+            built[scenesOfLevel[i]] = true;
+          });
+      }
+    };
+
+    /* for best performance set FTZ and DAZ flags in the MXCSR control and status register */
+    unsigned int mxcsr = _mm_getcsr();
+    _mm_setcsr(mxcsr | /* FTZ */ (1<<15) | /* DAZ */ (1<<6));
+
+    try {
+#if defined(TASKING_INTERNAL)
+      scheduler->spawn_root([&]() { build(); });
+#elif defined(TASKING_TBB)
+#if TBB_INTERFACE_VERSION_MAJOR < 8    
+      tbb::task_group_context ctx( tbb::task_group_context::isolated, tbb::task_group_context::default_traits);
+#else
+      tbb::task_group_context ctx( tbb::task_group_context::isolated, tbb::task_group_context::default_traits | tbb::task_group_context::fp_settings );
+#endif
+#if USE_TASK_ARENA
+      scenes_in[0]->device->arena->execute([&]{
+#endif
+          tbb::parallel_for (size_t(0), size_t(1), size_t(1), [&] (size_t) { build(); }, ctx);
+#if USE_TASK_ARENA
+        });
+#endif
+#else
+      concurrency::parallel_for(size_t(0), size_t(1), size_t(1), [&](size_t) { build(); });
+#endif
+      _mm_setcsr(mxcsr);
+    }
+    catch (...)
+    {
+      _mm_setcsr(mxcsr);
+      for (size_t i=0; i<scenes.size(); i++) {
+        if (built[i] || !scenes[i]->isModified()) continue;
+        scenes[i]->accels.clear();
+        scenes[i]->updateInterface();
+      }
+      unlock();
+      throw;
+    }
+    unlock();
+
+    for (auto scene : progressiveScenes)
+      scene->commitProgressive();
+  }
+
+  void Scene::commitAsync (RTCCommitFunction func, void* ptr)
+  {
+    if (!hasAsyncCommit())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"asynchronous commits require RTC_SCENE_FLAG_ASYNC_COMMIT or RTC_SCENE_FLAG_PROGRESSIVE_COMMIT");
+
+    Lock<MutexSys> lock(commitMutex);
+
+    /* only a single asynchronous commit can be pending */
+    if (commit_thread) {
+      join(commit_thread);
+      commit_thread = nullptr;
+    }
+
+    commit_function = func;
+    commit_ptr = ptr;
+    commit_preview = hasProgressiveCommit() && isModified();
+    commit_thread = createThread(commit_async_thread,this,4*1024*1024);
+  }
+
+  void Scene::commitPreview()
+  {
+    /* the preview always uses freshly created Morton hierarchies */
+    preview_build = true;
+    flags_modified = true;
+    try {
+      commit(false);
+    }
+    catch (...) {
+      preview_build = false;
+      flags_modified = true;
+      throw;
+    }
+    preview_build = false;
+
+    /* geometries stay committed, only the scene has to get rebuild at full quality */
+    setModified(true);
+  }
+
+  void Scene::commitProgressive()
+  {
+    waitCommit();
+    if (!isModified())
+      return;
+
+    commitPreview();
+
+    /* refine the preview in the background */
+    Lock<MutexSys> lock(commitMutex);
+    commit_function = nullptr;
+    commit_ptr = nullptr;
+    commit_preview = false;
+    commit_thread = createThread(commit_async_thread,this,4*1024*1024);
+  }
+
+  void Scene::commit_async_thread(void* ptr)
+  {
+    Scene* scene = (Scene*) ptr;
+    bool committed = false;
+    RTC_CATCH_BEGIN;
+    if (scene->commit_preview)
+      scene->commitPreview();
+    scene->commit(false);
+    committed = true;
+    RTC_CATCH_END2(scene);
+
+    if (scene->commit_function)
+      scene->commit_function(scene->commit_ptr,(RTCScene)scene,committed);
+  }
+
+  void Scene::waitCommit ()
+  {
+    Lock<MutexSys> lock(commitMutex);
+    if (commit_thread) {
+      join(commit_thread);
+      commit_thread = nullptr;
+    }
+  }
+
   void Scene::setProgressMonitorFunction(RTCProgressMonitorFunction func, void* ptr) 
   {
     static MutexSys mutex;
@@ -864,7 +1363,13 @@ namespace embree
   {
     if (progress_monitor_function) {
       size_t n = size_t(dn) + progress_monitor_counter.fetch_add(size_t(dn));
-      if (!progress_monitor_function(progress_monitor_ptr, n / (double(numPrimitives())))) {
+      double progress = n / (double(numPrimitives()));
+
+      /* the preview of progressive commits reports the first half, the refinement the second half */
+      if (hasProgressiveCommit())
+        progress = 0.5*(progress + (preview_build ? 0.0 : 1.0));
+      
+      if (!progress_monitor_function(progress_monitor_ptr, progress)) {
         throw_RTCError(RTC_ERROR_CANCELLED,"progress monitor forced termination");
       }
     }
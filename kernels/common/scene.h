@@ -128,6 +128,24 @@ namespace embree
     /*! prints statistics about the scene */
     void printStatistics();
 
+  private:
+    void beginCommit();
+    void finishCommit();
+
+    /*! moves the freshly built hierarchies into a new version and publishes it to ray queries */
+    void publishAccels();
+
+    /*! thread function of asynchronous commits */
+    static void commit_async_thread(void* ptr);
+
+    /*! builds and publishes a fast preview using the Morton builders, the full quality build stays pending */
+    void commitPreview();
+
+    /*! calculates a hash over the geometry data of all enabled geometries */
+    uint64_t geometryHash();
+
+  public:
+
     /*! clears the scene */
     void clear();
 
@@ -144,6 +162,24 @@ namespace embree
     void commit_task ();
     void build () {}
 
+    /*! commits multiple scenes together, scenes instanced by other scenes of the batch get built first */
+    static void commitScenes (Scene** scenes, size_t numScenes);
+
+    /*! commits the scene in the background, ray queries continue to use the last published version */
+    void commitAsync (RTCCommitFunction func, void* ptr);
+
+    /*! publishes a preview and refines it in the background, ray queries continue to use the last published version */
+    void commitProgressive ();
+
+    /*! waits until a pending asynchronous commit finished */
+    void waitCommit ();
+
+    /*! stores the hierarchies of the committed scene into a file */
+    void saveBVH(const std::string& fileName);
+
+    /*! commits the scene by loading the hierarchies from a file, returns false if the file does not match the scene */
+    bool loadBVH(const std::string& fileName);
+
     void updateInterface();
 
     /* return number of geometries */
@@ -151,10 +187,19 @@ namespace embree
     
     /* bind geometry to the scene */
     unsigned int bind (unsigned geomID, Ref<Geometry> geometry);
+
+    /* reserves num consecutive geometry IDs and returns the first one, can get called concurrently */
+    unsigned int reserveGeometryIDs (unsigned num);
+
+    /* binds geometries to reserved geometry IDs, can get called concurrently for different IDs */
+    void bind (unsigned firstGeomID, Ref<Geometry>* geometries, unsigned num);
     
     /* determines if scene is modified */
     __forceinline bool isModified() const { return modified; }
 
+    /* determines if ray queries can be issued, scenes with asynchronous commits use the last published version */
+    __forceinline bool isCommitted() const { return !modified || (hasAsyncCommit() && publishedAccels.load()); }
+
     /* sets modified flag */
     __forceinline void setModified(bool f = true) { 
       modified = f; 
@@ -197,6 +242,8 @@ namespace embree
     __forceinline bool isRobustAccel()  const { return scene_flags & RTC_SCENE_FLAG_ROBUST; }
     __forceinline bool isStaticAccel()  const { return !(scene_flags & RTC_SCENE_FLAG_DYNAMIC); }
     __forceinline bool isDynamicAccel() const { return scene_flags & RTC_SCENE_FLAG_DYNAMIC; }
+    __forceinline bool hasAsyncCommit() const { return scene_flags & (RTC_SCENE_FLAG_ASYNC_COMMIT | RTC_SCENE_FLAG_PROGRESSIVE_COMMIT); }
+    __forceinline bool hasProgressiveCommit() const { return scene_flags & RTC_SCENE_FLAG_PROGRESSIVE_COMMIT; }
     
     __forceinline bool hasContextFilterFunction() const {
       return scene_flags & RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION;
@@ -213,7 +260,7 @@ namespace embree
 
   public:
     IDPool<unsigned,0xFFFFFFFE> id_pool;
-    std::vector<Ref<Geometry>> geometries; //!< list of all user geometries
+    chunked_vector<Ref<Geometry>> geometries; //!< list of all user geometries
     vector<int*> vertices;
     
   public:
@@ -226,6 +273,16 @@ namespace embree
     SpinLock geometriesMutex;
     bool is_build;
     bool modified;                   //!< true if scene got modified
+
+    /* double buffering of scenes with asynchronous commits */
+    std::atomic<AccelN*> publishedAccels; //!< version all ray queries are forwarded to
+    AccelN* retiredAccels;                //!< previously published version, released by the next publish
+    MutexSys commitMutex;
+    thread_t commit_thread;
+    RTCCommitFunction commit_function;
+    void* commit_ptr;
+    bool commit_preview;                  //!< true if the pending asynchronous commit starts with a preview build
+    bool preview_build;                   //!< true while the Morton preview of a progressive commit gets build
     
     /*! global lock step task scheduler */
 #if defined(TASKING_INTERNAL) 
@@ -205,6 +205,16 @@ namespace embree
     return true;
   }
 
+  uint64_t NativeCurves::hash() const
+  {
+    uint64_t h = RawBufferView::hash_combine(uint64_t(Geometry::type),numTimeSteps);
+    h = RawBufferView::hash_combine(h,(uint64_t(type) << 32) | uint64_t(subtype));
+    h = curves.hash(sizeof(unsigned int),h);
+    for (const auto& buffer : vertices)
+      h = buffer.hash(4*sizeof(float),h);
+    return h;
+  }
+
   void NativeCurves::preCommit()
   {
     /* verify that stride of all time steps are identical */
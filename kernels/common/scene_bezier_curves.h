@@ -62,6 +62,7 @@ namespace embree
     void preCommit();
     void postCommit();
     bool verify();
+    uint64_t hash() const;
     void setTessellationRate(float N);
 
   public:
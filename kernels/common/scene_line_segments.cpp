@@ -176,6 +176,19 @@ namespace embree
     Geometry::update();
   }
 
+  void LineSegments::updateBufferRange(RTCBufferType type, unsigned int slot, size_t begin, size_t count)
+  {
+    if (type == RTC_BUFFER_TYPE_VERTEX)
+    {
+      if (slot >= vertices.size())
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+      vertices[slot].setModified(begin,begin+count);
+      Geometry::update();
+    }
+    else
+      updateBuffer(type,slot);
+  }
+
   void LineSegments::preCommit() 
   {
     /* verify that stride of all time steps are identical */
@@ -225,6 +238,15 @@ namespace embree
     return true;
   }
 
+  uint64_t LineSegments::hash() const
+  {
+    uint64_t h = RawBufferView::hash_combine(uint64_t(type),numTimeSteps);
+    h = segments.hash(sizeof(unsigned int),h);
+    for (const auto& buffer : vertices)
+      h = buffer.hash(4*sizeof(float),h);
+    return h;
+  }
+
   void LineSegments::interpolate(const RTCInterpolateArguments* const args)
   {
     unsigned int primID = args->primID;
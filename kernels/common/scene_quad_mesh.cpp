@@ -159,6 +159,19 @@ namespace embree
     Geometry::update();
   }
 
+  void QuadMesh::updateBufferRange(RTCBufferType type, unsigned int slot, size_t begin, size_t count)
+  {
+    if (type == RTC_BUFFER_TYPE_VERTEX)
+    {
+      if (slot >= vertices.size())
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+      vertices[slot].setModified(begin,begin+count);
+      Geometry::update();
+    }
+    else
+      updateBuffer(type,slot);
+  }
+
   void QuadMesh::preCommit() 
   {
     /* verify that stride of all time steps are identical */
@@ -207,6 +220,15 @@ namespace embree
     return true;
   }
 
+  uint64_t QuadMesh::hash() const
+  {
+    uint64_t h = RawBufferView::hash_combine(uint64_t(type),numTimeSteps);
+    h = quads.hash(sizeof(Quad),h);
+    for (const auto& buffer : vertices)
+      h = buffer.hash(3*sizeof(float),h);
+    return h;
+  }
+
   void QuadMesh::interpolate(const RTCInterpolateArguments* const args)
   {
     unsigned int primID = args->primID;
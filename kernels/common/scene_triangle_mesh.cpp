@@ -159,6 +159,19 @@ namespace embree
     Geometry::update();
   }
 
+  void TriangleMesh::updateBufferRange(RTCBufferType type, unsigned int slot, size_t begin, size_t count)
+  {
+    if (type == RTC_BUFFER_TYPE_VERTEX)
+    {
+      if (slot >= vertices.size())
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+      vertices[slot].setModified(begin,begin+count);
+      Geometry::update();
+    }
+    else
+      updateBuffer(type,slot);
+  }
+
   void TriangleMesh::preCommit() 
   {
     /* verify that stride of all time steps are identical */
@@ -210,6 +223,15 @@ namespace embree
 
     return true;
   }
+
+  uint64_t TriangleMesh::hash() const
+  {
+    uint64_t h = RawBufferView::hash_combine(uint64_t(type),numTimeSteps);
+    h = triangles.hash(sizeof(Triangle),h);
+    for (const auto& buffer : vertices)
+      h = buffer.hash(3*sizeof(float),h);
+    return h;
+  }
   
   void TriangleMesh::interpolate(const RTCInterpolateArguments* const args)
   {
@@ -53,9 +53,11 @@ namespace embree
     void setBuffer(RTCBufferType type, unsigned int slot, RTCFormat format, const Ref<Buffer>& buffer, size_t offset, size_t stride, unsigned int num);
     void* getBuffer(RTCBufferType type, unsigned int slot);
     void updateBuffer(RTCBufferType type, unsigned int slot);
+    void updateBufferRange(RTCBufferType type, unsigned int slot, size_t begin, size_t count);
     void preCommit();
     void postCommit();
     bool verify();
+    uint64_t hash() const;
     void interpolate(const RTCInterpolateArguments* const args);
 
   public:
@@ -94,6 +94,12 @@ namespace embree
     object_accel_mb_max_leaf_size = 1;
 
     max_spatial_split_replications = 2.0f;
+    max_presplit_replications = 1.0f;
+    restructure_time_budget = 0.0f;
+    restructure_iterations = 4;
+    incremental_update_threshold = 0.0f;
+    refit_rebuild_threshold = 0.0f;
+    unified_top_level = false;
 
     tessellation_cache_size = 128*1024*1024;
 
@@ -128,8 +134,11 @@ namespace embree
 #endif
     /* per default enable affinity on KNL */
     if (hasISA(AVX512KNL)) set_affinity = true;
+    isolated_threads = false;
+    affinity_offset = 0;
 
     start_threads = false;
+    idle_policy = 0;
     enable_selockmemoryprivilege = false;
 #if defined(__LINUX__)
     hugepages = true;
@@ -142,6 +151,7 @@ namespace embree
     alloc_num_main_slots = 0;
     alloc_thread_block_size = 0;
     alloc_single_thread_alloc = -1;
+    alloc_numa_aware = true;
 
     error_function = nullptr;
     error_function_userptr = nullptr;
@@ -238,6 +248,14 @@ namespace embree
     else return SSE2;
   }
 
+  int string_to_idle_policy(const std::string& policy)
+  {
+    if      (policy == "spin"    ) return 0;
+    else if (policy == "adaptive") return 1;
+    else if (policy == "sleep"   ) return 2;
+    else return 0;
+  }
+
   void State::parse(Ref<TokenStream> cin)
   {
     /* parse until end of stream */
@@ -253,9 +271,18 @@ namespace embree
 
       else if (tok == Token::Id("affinity")&& cin->trySymbol("=")) 
         set_affinity = cin->get().Int();
+
+      else if (tok == Token::Id("isolated_threads")&& cin->trySymbol("=")) 
+        isolated_threads = cin->get().Int();
+
+      else if (tok == Token::Id("affinity_offset")&& cin->trySymbol("=")) 
+        affinity_offset = cin->get().Int();
       
       else if (tok == Token::Id("start_threads")&& cin->trySymbol("=")) 
         start_threads = cin->get().Int();
+
+      else if (tok == Token::Id("idle_policy")&& cin->trySymbol("=")) 
+        idle_policy = string_to_idle_policy(toLowerCase(cin->get().Identifier()));
       
       else if (tok == Token::Id("isa") && cin->trySymbol("=")) {
         std::string isa = toLowerCase(cin->get().Identifier());
@@ -408,6 +435,19 @@ namespace embree
       
       else if (tok == Token::Id("max_spatial_split_replications") && cin->trySymbol("="))
         max_spatial_split_replications = cin->get().Float();
+      else if (tok == Token::Id("max_presplit_replications") && cin->trySymbol("="))
+        max_presplit_replications = cin->get().Float();
+
+      else if (tok == Token::Id("restructure_time_budget") && cin->trySymbol("="))
+        restructure_time_budget = cin->get().Float();
+      else if (tok == Token::Id("restructure_iterations") && cin->trySymbol("="))
+        restructure_iterations = cin->get().Int();
+      else if (tok == Token::Id("incremental_update_threshold") && cin->trySymbol("="))
+        incremental_update_threshold = cin->get().Float();
+      else if (tok == Token::Id("refit_rebuild_threshold") && cin->trySymbol("="))
+        refit_rebuild_threshold = cin->get().Float();
+      else if (tok == Token::Id("unified_top_level") && cin->trySymbol("="))
+        unified_top_level = cin->get().Int();
 
       else if (tok == Token::Id("tessellation_cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
@@ -422,6 +462,8 @@ namespace embree
          alloc_thread_block_size = cin->get().Int();
        else if (tok == Token::Id("alloc_single_thread_alloc") && cin->trySymbol("="))
          alloc_single_thread_alloc = cin->get().Int();
+       else if (tok == Token::Id("alloc_numa_aware") && cin->trySymbol("="))
+         alloc_numa_aware = cin->get().Int();
 
       cin->trySymbol(","); // optional , separator
     }
@@ -437,6 +479,12 @@ namespace embree
     std::cout << "  build threads = " << numThreads   << std::endl;
     std::cout << "  start_threads = " << start_threads << std::endl;
     std::cout << "  affinity      = " << set_affinity << std::endl;
+    std::cout << "  isolated      = " << isolated_threads << std::endl;
+    std::cout << "  affinity_offset = " << affinity_offset << std::endl;
+    std::cout << "  idle_policy   = ";
+    if      (idle_policy == 0) std::cout << "spin" << std::endl;
+    else if (idle_policy == 1) std::cout << "adaptive" << std::endl;
+    else                       std::cout << "sleep" << std::endl;
     
     std::cout << "  hugepages     = ";
     if (!hugepages) std::cout << "disabled" << std::endl;
@@ -446,6 +494,12 @@ namespace embree
     std::cout << "  verbosity     = " << verbose << std::endl;
     std::cout << "  cache_size    = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  max_presplit_replications = " << max_presplit_replications << std::endl;
+    std::cout << "  restructure_time_budget = " << restructure_time_budget << " ms" << std::endl;
+    std::cout << "  restructure_iterations = " << restructure_iterations << std::endl;
+    std::cout << "  incremental_update_threshold = " << incremental_update_threshold << std::endl;
+    std::cout << "  refit_rebuild_threshold = " << refit_rebuild_threshold << std::endl;
+    std::cout << "  unified_top_level = " << unified_top_level << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel         = " << tri_accel << std::endl;
@@ -111,6 +111,12 @@ namespace embree
 
   public:
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
+    float max_presplit_replications;       //!< maximally replications*N many primitives after pre-splitting large primitives, 1 disables pre-splitting
+    float restructure_time_budget;         //!< time in milliseconds to spend for treelet restructuring after builds, 0 disables restructuring
+    size_t restructure_iterations;         //!< maximal number of treelet restructuring passes
+    float incremental_update_threshold;    //!< maximal relative SAH cost increase of incrementally updated mesh BVHs before rebuilding, 0 disables incremental updates
+    float refit_rebuild_threshold;         //!< maximal relative SAH cost increase of refitted mesh BVHs before rebuilding, 0 disables quality monitoring
+    bool unified_top_level;                //!< traverses the acceleration structures of the different geometry types of a scene front to back
     size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
 
   public:
@@ -131,7 +137,10 @@ namespace embree
   public:
     size_t numThreads;                     //!< number of threads to use in builders
     bool set_affinity;                     //!< sets affinity for worker threads
+    bool isolated_threads;                 //!< device uses its own pool of worker threads instead of sharing the process wide pool
+    size_t affinity_offset;                //!< logical thread the first worker thread of an isolated pool gets pinned to
     bool start_threads;                    //!< true when threads should be started at device creation time
+    int idle_policy;                       //!< how idle threads of the internal tasking system wait: 0 = spin, 1 = adaptive, 2 = sleep
     int enabled_cpu_features;              //!< CPU ISA features to use
     int enabled_builder_cpu_features;      //!< CPU ISA features to use for builders only
     bool enable_selockmemoryprivilege;     //!< configures the SeLockMemoryPrivilege under Windows to enable huge pages
@@ -143,6 +152,7 @@ namespace embree
     int alloc_num_main_slots;              //!< number of such shared blocks to be used to allocate
     size_t alloc_thread_block_size;        //!< size of thread local allocator block size
     int alloc_single_thread_alloc;         //!< in single mode nodes and leaves use same thread local allocator
+    bool alloc_numa_aware;                 //!< threads of different NUMA nodes allocate from different blocks
 
   public:
     struct ErrorHandler
@@ -135,7 +135,7 @@ namespace embree
     {
       BBox3fa bounds = empty;
       vint<M> vgeomID = -1, vprimID = -1;
-      Vec3vf<M> v0 = zero, v1 = zero, v2 = zero;
+      Vec3vf<M> v0 = zero, v1 = zero, v2 = zero, v3 = zero;
 	
       for (size_t i=0; i<M; i++)
       {
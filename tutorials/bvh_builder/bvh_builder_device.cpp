@@ -102,7 +102,7 @@ namespace embree
     }
   };
 
-  void build(RTCBuildQuality quality, avector<RTCBuildPrimitive>& prims_i, char* cfg, size_t extraSpace = 0)
+  void build(RTCBuildQuality quality, avector<RTCBuildPrimitive>& prims_i, char* cfg, size_t extraSpace = 0, RTCBuildFlags flags = RTC_BUILD_FLAG_NONE)
   {
     RTCDevice device = rtcNewDevice(cfg);
     rtcSetDeviceMemoryMonitorFunction(device,memoryMonitor,nullptr);
@@ -116,7 +116,7 @@ namespace embree
     /* settings for BVH build */
     RTCBuildArguments arguments = rtcDefaultBuildArguments();
     arguments.byteSize = sizeof(arguments);
-    arguments.buildFlags = RTC_BUILD_FLAG_DYNAMIC;
+    arguments.buildFlags = (RTCBuildFlags) (RTC_BUILD_FLAG_DYNAMIC | flags);
     arguments.buildQuality = quality;
     arguments.maxBranchingFactor = 2;
     arguments.maxDepth = 1024;
@@ -197,6 +197,9 @@ namespace embree
     std::cout << "Normal quality BVH build:" << std::endl;
     build(RTC_BUILD_QUALITY_MEDIUM,prims,cfg);
 
+    std::cout << "Normal quality BVH build using clustering:" << std::endl;
+    build(RTC_BUILD_QUALITY_MEDIUM,prims,cfg,0,RTC_BUILD_FLAG_CLUSTERING);
+
     std::cout << "High quality BVH build:" << std::endl;
     build(RTC_BUILD_QUALITY_HIGH,prims,cfg,extraSpace);
   }
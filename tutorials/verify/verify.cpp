@@ -723,6 +723,72 @@ namespace embree
     }
   };
 
+  struct IsolatedDevicesTest : public VerifyApplication::Test
+  {
+    IsolatedDevicesTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    struct ThreadData
+    {
+      RTCDeviceRef* device;
+      std::atomic<size_t> errorCounter;
+    };
+
+    /* each thread repeatedly builds scenes on its own device */
+    static void build_thread(void* ptr)
+    {
+      ThreadData* data = (ThreadData*) ptr;
+      RandomSampler sampler;
+      RandomSampler_init(sampler,1);
+      for (size_t i=0; i<8; i++)
+      {
+        VerifyScene scene(*data->device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+        scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-2,0,0),1.0f,100);
+        scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(+2,0,0),1.0f,100);
+        rtcCommitScene(scene);
+
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        RTCRayHit ray0 = makeRay(Vec3fa(-2,0,-10),Vec3fa(0,0,1));
+        RTCRayHit ray1 = makeRay(Vec3fa(+2,0,-10),Vec3fa(0,0,1));
+        rtcIntersect1(scene,&context,&ray0);
+        rtcIntersect1(scene,&context,&ray1);
+        if (ray0.hit.geomID != 0 || ray1.hit.geomID != 1) data->errorCounter++;
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef shared    = rtcNewDevice(cfg.c_str());
+      RTCDeviceRef isolated0 = rtcNewDevice((cfg+",isolated_threads=1,threads=2").c_str());
+      RTCDeviceRef isolated1 = rtcNewDevice((cfg+",isolated_threads=1,threads=2,affinity_offset=2").c_str());
+      AssertNoError(shared);
+      AssertNoError(isolated0);
+      AssertNoError(isolated1);
+
+      /* builds of all devices run concurrently, the isolated devices use their own worker threads */
+      ThreadData data[3];
+      data[0].device = &shared;
+      data[1].device = &isolated0;
+      data[2].device = &isolated1;
+      std::vector<thread_t> threads;
+      for (size_t i=0; i<3; i++) {
+        data[i].errorCounter = 0;
+        threads.push_back(createThread(build_thread,&data[i],DEFAULT_STACK_SIZE));
+      }
+      for (size_t i=0; i<threads.size(); i++)
+        join(threads[i]);
+
+      AssertNoError(shared);
+      AssertNoError(isolated0);
+      AssertNoError(isolated1);
+      for (size_t i=0; i<3; i++)
+        if (data[i].errorCounter) return VerifyApplication::FAILED;
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct GetBoundsTest : public VerifyApplication::Test
   {
     GeometryType gtype;
@@ -1090,6 +1156,791 @@ namespace embree
     }
   };
 
+  struct SaveLoadBVHTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    SaveLoadBVHTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    Ref<VerifyScene> createScene(const RTCDeviceRef& device, float radius)
+    {
+      Ref<VerifyScene> scene = new VerifyScene(device,sflags);
+      const Vec3fa dx(1,0,0);
+      const Vec3fa dy(0,1,0);
+      scene->addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTriangleSphere(Vec3fa(-1,-1,0),radius,50));
+      scene->addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTriangleSphere(Vec3fa(+1,-1,0),radius,50)->set_motion_vector(Vec3fa(0.1f,0,0)));
+      scene->addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadSphere(Vec3fa(-1,+1,0),radius,50));
+      scene->addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createHairyPlane(1,Vec3fa(+1,+1,0),dx,dy,0.1f,0.01f,100,SceneGraph::FLAT_CURVE));
+      return scene;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      const std::string fileName = "verify_save_load_bvh."+stringOfISA(isa)+"."+name+".bin"; // tests may run in parallel
+
+      Ref<VerifyScene> scene0 = createScene(device,1.0f);
+      rtcCommitScene (*scene0);
+      rtcSaveSceneBVH(*scene0,fileName.c_str());
+      AssertNoError(device);
+
+      /* loading has to succeed for identical geometry */
+      Ref<VerifyScene> scene1 = createScene(device,1.0f);
+      bool loaded1 = rtcLoadSceneBVH(*scene1,fileName.c_str());
+      AssertNoError(device);
+
+      /* loading has to fail for modified geometry */
+      Ref<VerifyScene> scene2 = createScene(device,0.5f);
+      bool loaded2 = rtcLoadSceneBVH(*scene2,fileName.c_str());
+      AssertNoError(device);
+      std::remove(fileName.c_str());
+      if (!loaded1 || loaded2)
+        return VerifyApplication::FAILED;
+
+      /* the loaded scene has to report the same hits as the built scene */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org(4.0f*RandomSampler_get1D(sampler)-2.0f,4.0f*RandomSampler_get1D(sampler)-2.0f,-10.0f);
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1)); ray0.ray.time = RandomSampler_get1D(sampler);
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(*scene0,&context,&ray0);
+        rtcIntersect1(*scene1,&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct AsyncCommitTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    AsyncCommitTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static void commitDone(void* ptr, RTCScene scene, bool committed) {
+      ((std::atomic<size_t>*)ptr)->fetch_add(1);
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,SceneFlags(sflags.sflags | RTC_SCENE_FLAG_ASYNC_COMMIT,sflags.qflags));
+      std::atomic<size_t> numCallbacks(0);
+
+      /* the first version contains the left sphere only */
+      scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-2,0,0),1.0f,50);
+      rtcCommitSceneAsync(scene,commitDone,&numCallbacks);
+      rtcWaitCommitScene(scene);
+      AssertNoError(device);
+
+      /* rays towards the left sphere have to hit while the second version gets built */
+      scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(+2,0,0),1.0f,200);
+      rtcCommitSceneAsync(scene,commitDone,&numCallbacks);
+
+      bool passed = true;
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      do {
+        RTCRayHit ray0 = makeRay(Vec3fa(-2,0,-10),Vec3fa(0,0,1));
+        rtcIntersect1(scene,&context,&ray0);
+        passed &= ray0.hit.geomID == 0;
+      } while (numCallbacks < 2);
+      rtcWaitCommitScene(scene);
+      AssertNoError(device);
+
+      /* the second version is visible once the commit finished */
+      RTCRayHit ray1 = makeRay(Vec3fa(+2,0,-10),Vec3fa(0,0,1));
+      rtcIntersect1(scene,&context,&ray1);
+      passed &= ray1.hit.geomID == 1;
+      AssertNoError(device);
+
+      /* asynchronous commits require the scene flag */
+      VerifyScene scene2(device,sflags);
+      rtcCommitSceneAsync(scene2,nullptr,nullptr);
+      AssertError(device,RTC_ERROR_INVALID_OPERATION);
+
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct ProgressiveCommitTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    ProgressiveCommitTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static bool monitorProgress(void* ptr, double n)
+    {
+      std::atomic<size_t>& progress = *(std::atomic<size_t>*)ptr;
+      size_t p = size_t(n*1000.0), q = progress;
+      while (p > q && !progress.compare_exchange_weak(q,p));
+      return true;
+    }
+
+    static void commitDone(void* ptr, RTCScene scene, bool committed) {
+      if (committed) ((std::atomic<size_t>*)ptr)->fetch_add(1);
+    }
+
+    bool hits(RTCScene scene, const Vec3fa& org, unsigned int geomID)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit ray = makeRay(org,Vec3fa(0,0,1));
+      rtcIntersect1(scene,&context,&ray);
+      return ray.hit.geomID == geomID;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,SceneFlags(sflags.sflags | RTC_SCENE_FLAG_PROGRESSIVE_COMMIT,sflags.qflags));
+      std::atomic<size_t> progress(0);
+      rtcSetSceneProgressMonitorFunction(scene,monitorProgress,&progress);
+
+      /* the preview is usable as soon as the commit returns */
+      scene.addSphere    (sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-2,0,0),1.0f,50);
+      scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(+2,0,0),1.0f,50);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+      bool passed = hits(scene,Vec3fa(-2,0,-10),0) && hits(scene,Vec3fa(+2,0,-10),1);
+
+      /* the refined version reports the second half of the progress */
+      rtcWaitCommitScene(scene);
+      AssertNoError(device);
+      passed &= hits(scene,Vec3fa(-2,0,-10),0) && hits(scene,Vec3fa(+2,0,-10),1);
+      passed &= progress > 500 && progress <= 1000;
+
+      /* asynchronous commits invoke the callback once the refinement finished */
+      std::atomic<size_t> numCallbacks(0);
+      scene.addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,4,0),1.0f,50);
+      rtcCommitSceneAsync(scene,commitDone,&numCallbacks);
+      rtcWaitCommitScene(scene);
+      AssertNoError(device);
+      passed &= numCallbacks == 1 && hits(scene,Vec3fa(0,4,-10),2);
+      
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct BuildBVHTest : public VerifyApplication::Test
+  {
+    RTCBuildQuality quality;
+    RTCBuildFlags flags;
+    size_t N;
+
+    BuildBVHTest (std::string name, int isa, RTCBuildQuality quality, RTCBuildFlags flags, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), quality(quality), flags(flags), N(N) {}
+
+    struct Node
+    {
+      unsigned int numChildren;    //!< 0 for leaves
+      unsigned int numPrims;       //!< number of primitives of leaves
+      BBox3fa bounds[4];
+      void* children[4];           //!< for leaves children[0] points to the primitive IDs
+    };
+
+    static void* createNode (RTCThreadLocalAllocator alloc, unsigned int numChildren, void* userPtr)
+    {
+      Node* node = (Node*) rtcThreadLocalAlloc(alloc,sizeof(Node),16);
+      node->numChildren = numChildren;
+      node->numPrims = 0;
+      return node;
+    }
+
+    static void setNodeChildren (void* nodePtr, void** children, unsigned int numChildren, void* userPtr)
+    {
+      for (size_t i=0; i<numChildren; i++)
+        ((Node*)nodePtr)->children[i] = children[i];
+    }
+
+    static void setNodeBounds (void* nodePtr, const RTCBounds** bounds, unsigned int numChildren, void* userPtr)
+    {
+      for (size_t i=0; i<numChildren; i++)
+        ((Node*)nodePtr)->bounds[i] = *(const BBox3fa*) bounds[i];
+    }
+
+    static void* createLeaf (RTCThreadLocalAllocator alloc, const RTCBuildPrimitive* prims, size_t numPrims, void* userPtr)
+    {
+      Node* node = (Node*) rtcThreadLocalAlloc(alloc,sizeof(Node),16);
+      unsigned int* primIDs = (unsigned int*) rtcThreadLocalAlloc(alloc,max(size_t(1),numPrims)*sizeof(unsigned int),16);
+      for (size_t i=0; i<numPrims; i++) primIDs[i] = prims[i].primID;
+      node->numChildren = 0;
+      node->numPrims = (unsigned int) numPrims;
+      node->children[0] = primIDs;
+      return node;
+    }
+
+    /* checks that child bounds enclose the subtree and counts how often each primitive is referenced */
+    bool validate(const Node* node, const std::vector<BBox3fa>& bounds, std::vector<size_t>& refs, BBox3fa& nodeBounds)
+    {
+      nodeBounds = empty;
+      if (node->numChildren == 0)
+      {
+        const unsigned int* primIDs = (const unsigned int*) node->children[0];
+        for (size_t i=0; i<node->numPrims; i++) {
+          if (primIDs[i] >= bounds.size()) return false;
+          refs[primIDs[i]]++;
+          nodeBounds.extend(bounds[primIDs[i]]);
+        }
+        return true;
+      }
+
+      bool passed = true;
+      for (size_t i=0; i<node->numChildren; i++)
+      {
+        BBox3fa childBounds;
+        passed &= validate((const Node*)node->children[i],bounds,refs,childBounds);
+        passed &= subset(childBounds,node->bounds[i]);
+        nodeBounds.extend(node->bounds[i]);
+      }
+      return passed;
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      RTCBVH bvh = rtcNewBVH(device);
+      AssertNoError(device);
+
+      std::vector<BBox3fa> bounds(N);
+      avector<RTCBuildPrimitive> prims(N);
+      for (size_t i=0; i<N; i++)
+      {
+        const Vec3fa p = 100.0f*Vec3fa(RandomSampler_get1D(sampler),RandomSampler_get1D(sampler),RandomSampler_get1D(sampler));
+        bounds[i] = BBox3fa(p,p+Vec3fa(RandomSampler_get1D(sampler)));
+        RTCBuildPrimitive& prim = prims[i];
+        prim.lower_x = bounds[i].lower.x; prim.lower_y = bounds[i].lower.y; prim.lower_z = bounds[i].lower.z; prim.geomID = 0;
+        prim.upper_x = bounds[i].upper.x; prim.upper_y = bounds[i].upper.y; prim.upper_z = bounds[i].upper.z; prim.primID = (unsigned int) i;
+      }
+
+      RTCBuildArguments arguments = rtcDefaultBuildArguments();
+      arguments.buildQuality = quality;
+      arguments.buildFlags = flags;
+      arguments.maxBranchingFactor = 4;
+      arguments.maxLeafSize = 8;
+      arguments.bvh = bvh;
+      arguments.primitives = prims.data();
+      arguments.primitiveCount = prims.size();
+      arguments.primitiveArrayCapacity = prims.size();
+      arguments.createNode = createNode;
+      arguments.setNodeChildren = setNodeChildren;
+      arguments.setNodeBounds = setNodeBounds;
+      arguments.createLeaf = createLeaf;
+      Node* root = (Node*) rtcBuildBVH(&arguments);
+      AssertNoError(device);
+
+      /* every primitive has to be referenced exactly once */
+      std::vector<size_t> refs(N,0);
+      BBox3fa rootBounds;
+      bool passed = root && validate(root,bounds,refs,rootBounds);
+      for (size_t i=0; i<N; i++)
+        passed &= refs[i] == 1;
+
+      rtcReleaseBVH(bvh);
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct RestructureTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    std::string builder;
+
+    RestructureTest (std::string name, int isa, SceneFlags sflags, std::string builder)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), builder(builder) {}
+
+    void createScene(VerifyScene& scene)
+    {
+      RandomSampler sampler;
+      RandomSampler_init(sampler,1);
+      scene.addSphere    (sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-2,0,0),1.0f,100,10000);
+      scene.addQuadSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(+2,0,0),1.0f,100,10000);
+      scene.addSphere    (sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(0,+2,1),1.5f,50);
+      rtcCommitScene(scene);
+    }
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      /* the reference scene gets built without restructuring */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa) + builder;
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice((cfg+",restructure_time_budget=10000").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+      VerifyScene scene0(device0,sflags); createScene(scene0);
+      VerifyScene scene1(device1,sflags); createScene(scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* restructuring must not change any hit */
+      bool passed = true;
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<10000; i++)
+      {
+        const Vec3fa org(8.0f*RandomSampler_get1D(sampler)-4.0f,8.0f*RandomSampler_get1D(sampler)-4.0f,-10.0f);
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1));
+        RTCRayHit ray1 = makeRay(org,Vec3fa(0,0,1));
+        rtcIntersect1(scene0,&context,&ray0);
+        rtcIntersect1(scene1,&context,&ray1);
+        passed &= ray0.hit.geomID == ray1.hit.geomID;
+        passed &= ray0.ray.tfar == ray1.ray.tfar; // primitives hit at the same distance might get reported in different order
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct IncrementalUpdateTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCGeometryType gtype;
+
+    IncrementalUpdateTest (std::string name, int isa, SceneFlags sflags, RTCGeometryType gtype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      /* the reference scene gets rebuilt from scratch at each commit */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice((cfg+",incremental_update_threshold=1").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* both scenes share the same buffers of randomly placed primitives */
+      const size_t numVerts = gtype == RTC_GEOMETRY_TYPE_QUAD ? 4 : 3;
+      const size_t maxPrims = 12000;
+      size_t numPrims = 10000;
+      avector<Vec3fa> vertices(numVerts*maxPrims);
+      std::vector<unsigned> indices(numVerts*maxPrims);
+      for (size_t i=0; i<indices.size(); i++) indices[i] = (unsigned) i;
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler,2);
+      auto randomPrim = [&] (size_t i) {
+        const Vec3fa p = 8.0f*RandomSampler_get3D(sampler)-Vec3fa(4.0f);
+        for (size_t j=0; j<numVerts; j++)
+          vertices[numVerts*i+j] = p + 0.2f*RandomSampler_get3D(sampler);
+      };
+      for (size_t i=0; i<maxPrims; i++) randomPrim(i);
+
+      RTCGeometry geom[2];
+      RTCScene scenes[2] = { scene0, scene1 };
+      for (size_t i=0; i<2; i++)
+      {
+        geom[i] = rtcNewGeometry(i == 0 ? device0 : device1, gtype);
+        rtcSetSharedGeometryBuffer(geom[i],RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,vertices.data(),0,sizeof(Vec3fa),(unsigned int)(numVerts*maxPrims));
+        rtcSetSharedGeometryBuffer(geom[i],RTC_BUFFER_TYPE_INDEX,0,numVerts == 4 ? RTC_FORMAT_UINT4 : RTC_FORMAT_UINT3,indices.data(),0,numVerts*sizeof(unsigned),(unsigned int)numPrims);
+        rtcCommitGeometry(geom[i]);
+        rtcAttachGeometry(scenes[i],geom[i]);
+        rtcReleaseGeometry(geom[i]);
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      bool passed = true;
+      for (size_t iter=0; iter<8 && passed; iter++)
+      {
+        /* move, rotate, add, and remove some primitives */
+        if (iter > 0)
+        {
+          for (size_t i=0; i<50; i++)
+            randomPrim(RandomSampler_get1D(sampler)*numPrims);
+          for (size_t i=0; i<20; i++) {
+            unsigned* prim = &indices[numVerts*size_t(RandomSampler_get1D(sampler)*numPrims)];
+            std::rotate(prim,prim+1,prim+numVerts);
+          }
+          numPrims = iter%2 ? numPrims+200 : numPrims-150;
+
+          for (size_t i=0; i<2; i++) {
+            rtcSetSharedGeometryBuffer(geom[i],RTC_BUFFER_TYPE_INDEX,0,numVerts == 4 ? RTC_FORMAT_UINT4 : RTC_FORMAT_UINT3,indices.data(),0,numVerts*sizeof(unsigned),(unsigned int)numPrims);
+            rtcUpdateGeometryBuffer(geom[i],RTC_BUFFER_TYPE_VERTEX,0);
+            rtcCommitGeometry(geom[i]);
+          }
+        }
+        rtcCommitScene(scene0);
+        rtcCommitScene(scene1);
+        AssertNoError(device0);
+        AssertNoError(device1);
+
+        /* incrementally updated BVH has to find the same hits */
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        for (size_t i=0; i<2000; i++)
+        {
+          const Vec3fa org(10.0f*RandomSampler_get1D(sampler)-5.0f,10.0f*RandomSampler_get1D(sampler)-5.0f,-10.0f);
+          RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1));
+          RTCRayHit ray1 = makeRay(org,Vec3fa(0,0,1));
+          rtcIntersect1(scene0,&context,&ray0);
+          rtcIntersect1(scene1,&context,&ray1);
+          passed &= ray0.hit.geomID == ray1.hit.geomID;
+          passed &= ray0.hit.primID == ray1.hit.primID;
+          passed &= ray0.ray.tfar == ray1.ray.tfar;
+        }
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct PartialRefitTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCGeometryType gtype;
+
+    PartialRefitTest (std::string name, int isa, SceneFlags sflags, RTCGeometryType gtype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene0(device,sflags);
+      VerifyScene scene1(device,sflags);
+      AssertNoError(device);
+
+      /* both scenes share the same vertex buffer of randomly placed primitives */
+      const size_t numVerts = gtype == RTC_GEOMETRY_TYPE_QUAD ? 4 : 3;
+      const size_t numPrims = 10000;
+      avector<Vec3fa> vertices(numVerts*numPrims);
+      std::vector<unsigned> indices(numVerts*numPrims);
+      for (size_t i=0; i<indices.size(); i++) indices[i] = (unsigned) i;
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler,3);
+      auto randomPrim = [&] (size_t i) {
+        const Vec3fa p = 8.0f*RandomSampler_get3D(sampler)-Vec3fa(4.0f);
+        for (size_t j=0; j<numVerts; j++)
+          vertices[numVerts*i+j] = p + 0.2f*RandomSampler_get3D(sampler);
+      };
+      for (size_t i=0; i<numPrims; i++) randomPrim(i);
+
+      RTCGeometry geom[2];
+      RTCScene scenes[2] = { scene0, scene1 };
+      for (size_t i=0; i<2; i++)
+      {
+        geom[i] = rtcNewGeometry(device, gtype);
+        rtcSetGeometryBuildQuality(geom[i],RTC_BUILD_QUALITY_REFIT);
+        rtcSetSharedGeometryBuffer(geom[i],RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,vertices.data(),0,sizeof(Vec3fa),(unsigned int)(numVerts*numPrims));
+        rtcSetSharedGeometryBuffer(geom[i],RTC_BUFFER_TYPE_INDEX,0,numVerts == 4 ? RTC_FORMAT_UINT4 : RTC_FORMAT_UINT3,indices.data(),0,numVerts*sizeof(unsigned),(unsigned int)numPrims);
+        rtcCommitGeometry(geom[i]);
+        rtcAttachGeometry(scenes[i],geom[i]);
+        rtcReleaseGeometry(geom[i]);
+      }
+      AssertNoError(device);
+
+      bool passed = true;
+      for (size_t iter=0; iter<8 && passed; iter++)
+      {
+        /* move some runs of primitives, too many runs mark the entire buffer as modified */
+        if (iter > 0)
+        {
+          const size_t numRuns = iter == 4 ? 100 : 10;
+          for (size_t i=0; i<numRuns; i++)
+          {
+            const size_t begin = size_t(RandomSampler_get1D(sampler)*(numPrims-20));
+            const size_t count = 1+size_t(RandomSampler_get1D(sampler)*19);
+            for (size_t j=begin; j<begin+count; j++) randomPrim(j);
+            rtcUpdateGeometryBufferRange(geom[1],RTC_BUFFER_TYPE_VERTEX,0,(unsigned int)(numVerts*begin),(unsigned int)(numVerts*count));
+          }
+          rtcUpdateGeometryBuffer(geom[0],RTC_BUFFER_TYPE_VERTEX,0);
+          rtcCommitGeometry(geom[0]);
+          rtcCommitGeometry(geom[1]);
+        }
+        rtcCommitScene(scene0);
+        rtcCommitScene(scene1);
+        AssertNoError(device);
+
+        /* partially refitted BVH has to find the same hits */
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        for (size_t i=0; i<2000; i++)
+        {
+          const Vec3fa org(10.0f*RandomSampler_get1D(sampler)-5.0f,10.0f*RandomSampler_get1D(sampler)-5.0f,-10.0f);
+          RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1));
+          RTCRayHit ray1 = makeRay(org,Vec3fa(0,0,1));
+          rtcIntersect1(scene0,&context,&ray0);
+          rtcIntersect1(scene1,&context,&ray1);
+          passed &= ray0.hit.geomID == ray1.hit.geomID;
+          passed &= ray0.hit.primID == ray1.hit.primID;
+          passed &= ray0.ray.tfar == ray1.ray.tfar;
+        }
+      }
+      AssertNoError(device);
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct RefitRebuildTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCGeometryType gtype;
+
+    RefitRebuildTest (std::string name, int isa, SceneFlags sflags, RTCGeometryType gtype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      /* the reference scene always gets refitted */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice((cfg+",refit_rebuild_threshold=0.5").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* both scenes share the same buffers of primitives placed on a line */
+      const size_t numVerts = gtype == RTC_GEOMETRY_TYPE_QUAD ? 4 : 3;
+      const size_t numPrims = 10000;
+      avector<Vec3fa> vertices(numVerts*numPrims);
+      std::vector<unsigned> indices(numVerts*numPrims);
+      for (size_t i=0; i<indices.size(); i++) indices[i] = (unsigned) i;
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler,4);
+      auto placePrim = [&] (size_t i, const Vec3fa& p) {
+        for (size_t j=0; j<numVerts; j++)
+          vertices[numVerts*i+j] = p + 0.2f*RandomSampler_get3D(sampler);
+      };
+      for (size_t i=0; i<numPrims; i++)
+        placePrim(i,Vec3fa(8.0f*float(i)/float(numPrims)-4.0f,0.0f,0.0f));
+
+      RTCGeometry geom[2];
+      RTCScene scenes[2] = { scene0, scene1 };
+      for (size_t i=0; i<2; i++)
+      {
+        geom[i] = rtcNewGeometry(i == 0 ? device0 : device1, gtype);
+        rtcSetGeometryBuildQuality(geom[i],RTC_BUILD_QUALITY_REFIT);
+        rtcSetSharedGeometryBuffer(geom[i],RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,vertices.data(),0,sizeof(Vec3fa),(unsigned int)(numVerts*numPrims));
+        rtcSetSharedGeometryBuffer(geom[i],RTC_BUFFER_TYPE_INDEX,0,numVerts == 4 ? RTC_FORMAT_UINT4 : RTC_FORMAT_UINT3,indices.data(),0,numVerts*sizeof(unsigned),(unsigned int)numPrims);
+        rtcCommitGeometry(geom[i]);
+        rtcAttachGeometry(scenes[i],geom[i]);
+        rtcReleaseGeometry(geom[i]);
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      bool passed = true;
+      for (size_t iter=0; iter<4 && passed; iter++)
+      {
+        /* scattering the primitives degrades the refitted BVH */
+        if (iter > 0)
+        {
+          for (size_t i=0; i<numPrims; i++)
+            placePrim(i,8.0f*RandomSampler_get3D(sampler)-Vec3fa(4.0f));
+          for (size_t i=0; i<2; i++) {
+            rtcUpdateGeometryBuffer(geom[i],RTC_BUFFER_TYPE_VERTEX,0);
+            rtcCommitGeometry(geom[i]);
+          }
+        }
+        rtcCommitScene(scene0);
+        rtcCommitScene(scene1);
+        AssertNoError(device0);
+        AssertNoError(device1);
+
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        for (size_t i=0; i<2000; i++)
+        {
+          const Vec3fa org(10.0f*RandomSampler_get1D(sampler)-5.0f,10.0f*RandomSampler_get1D(sampler)-5.0f,-10.0f);
+          RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1));
+          RTCRayHit ray1 = makeRay(org,Vec3fa(0,0,1));
+          rtcIntersect1(scene0,&context,&ray0);
+          rtcIntersect1(scene1,&context,&ray1);
+          passed &= ray0.hit.geomID == ray1.hit.geomID;
+          passed &= ray0.hit.primID == ray1.hit.primID;
+          passed &= ray0.ray.tfar == ray1.ray.tfar;
+        }
+      }
+
+      /* only the monitored BVH got rebuilt */
+      passed &= rtcGetDeviceProperty(device0,RTC_DEVICE_PROPERTY_REFIT_REBUILD_COUNT) == 0;
+      passed &= rtcGetDeviceProperty(device1,RTC_DEVICE_PROPERTY_REFIT_REBUILD_COUNT) > 0;
+      AssertNoError(device0);
+      AssertNoError(device1);
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct SpatialSplitMBlurTest : public VerifyApplication::Test
+  {
+    RTCGeometryType gtype;
+    unsigned int numTimeSteps;
+
+    SpatialSplitMBlurTest (std::string name, int isa, RTCGeometryType gtype, unsigned int numTimeSteps)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype), numTimeSteps(numTimeSteps) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* the medium quality scene is the reference for the scene built with spatial splits */
+      VerifyScene scene0(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      VerifyScene scene1(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_HIGH));
+      AssertNoError(device);
+
+      /* long thin diagonal primitives moving randomly */
+      const size_t numVerts = gtype == RTC_GEOMETRY_TYPE_QUAD ? 4 : 3;
+      const size_t numPrims = 2000;
+      std::vector<avector<Vec3fa>> vertices(numTimeSteps,avector<Vec3fa>(numVerts*numPrims));
+      std::vector<unsigned> indices(numVerts*numPrims);
+      for (size_t i=0; i<indices.size(); i++) indices[i] = (unsigned) i;
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler,5);
+      for (size_t i=0; i<numPrims; i++)
+      {
+        const Vec3fa p = 4.0f*RandomSampler_get3D(sampler)-Vec3fa(2.0f);
+        const Vec3fa d = 2.0f*RandomSampler_get3D(sampler)-Vec3fa(1.0f);
+        const Vec3fa e = 0.02f*RandomSampler_get3D(sampler);
+        for (size_t t=0; t<numTimeSteps; t++)
+        {
+          const Vec3fa m = 0.2f*RandomSampler_get3D(sampler);
+          vertices[t][numVerts*i+0] = p+m-d;
+          vertices[t][numVerts*i+1] = p+m+d;
+          vertices[t][numVerts*i+2] = p+m+d+e;
+          if (numVerts == 4) vertices[t][numVerts*i+3] = p+m-d+e;
+        }
+      }
+
+      RTCScene scenes[2] = { scene0, scene1 };
+      for (size_t i=0; i<2; i++)
+      {
+        RTCGeometry geom = rtcNewGeometry(device, gtype);
+        rtcSetGeometryTimeStepCount(geom,numTimeSteps);
+        for (unsigned int t=0; t<numTimeSteps; t++)
+          rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,t,RTC_FORMAT_FLOAT3,vertices[t].data(),0,sizeof(Vec3fa),(unsigned int)(numVerts*numPrims));
+        rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,numVerts == 4 ? RTC_FORMAT_UINT4 : RTC_FORMAT_UINT3,indices.data(),0,numVerts*sizeof(unsigned),(unsigned int)numPrims);
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scenes[i],geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scenes[i]);
+      }
+      AssertNoError(device);
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<10000; i++)
+      {
+        const Vec3fa org(6.0f*RandomSampler_get1D(sampler)-3.0f,6.0f*RandomSampler_get1D(sampler)-3.0f,-10.0f);
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1)); ray0.ray.time = RandomSampler_get1D(sampler);
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&context,&ray0);
+        rtcIntersect1(scene1,&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct PresplitTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    RTCGeometryType gtype;
+
+    PresplitTest (std::string name, int isa, SceneFlags sflags, RTCGeometryType gtype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      /* the reference scene gets built without pre-splitting */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice((cfg+",max_presplit_replications=2").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      /* large diagonal primitives mixed with small ones */
+      const size_t numVerts = gtype == RTC_GEOMETRY_TYPE_QUAD ? 4 : 3;
+      const size_t numPrims = 3000;
+      avector<Vec3fa> vertices(numVerts*numPrims);
+      std::vector<unsigned> indices(numVerts*numPrims);
+      for (size_t i=0; i<indices.size(); i++) indices[i] = (unsigned) i;
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler,7);
+      for (size_t i=0; i<numPrims; i++)
+      {
+        const float size = i%10 == 0 ? 2.0f : 0.05f;
+        const Vec3fa p = 4.0f*RandomSampler_get3D(sampler)-Vec3fa(2.0f);
+        const Vec3fa d = size*(2.0f*RandomSampler_get3D(sampler)-Vec3fa(1.0f));
+        const Vec3fa e = size*(2.0f*RandomSampler_get3D(sampler)-Vec3fa(1.0f));
+        vertices[numVerts*i+0] = p-d;
+        vertices[numVerts*i+1] = p+d;
+        vertices[numVerts*i+2] = p+d+e;
+        if (numVerts == 4) vertices[numVerts*i+3] = p-d+e;
+      }
+
+      RTCDevice devices[2] = { device0, device1 };
+      RTCScene scenes[2] = { scene0, scene1 };
+      for (size_t i=0; i<2; i++)
+      {
+        RTCGeometry geom = rtcNewGeometry(devices[i], gtype);
+        rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,vertices.data(),0,sizeof(Vec3fa),(unsigned int)(numVerts*numPrims));
+        rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,numVerts == 4 ? RTC_FORMAT_UINT4 : RTC_FORMAT_UINT3,indices.data(),0,numVerts*sizeof(unsigned),(unsigned int)numPrims);
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scenes[i],geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scenes[i]);
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (size_t i=0; i<10000; i++)
+      {
+        const Vec3fa org(6.0f*RandomSampler_get1D(sampler)-3.0f,6.0f*RandomSampler_get1D(sampler)-3.0f,-10.0f);
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,1));
+        RTCRayHit ray1 = ray0;
+        rtcIntersect1(scene0,&context,&ray0);
+        rtcIntersect1(scene1,&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID || ray0.ray.tfar != ray1.ray.tfar)
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct OverlappingGeometryTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
@@ -1646,6 +2497,238 @@ namespace embree
     }
   };
 
+  struct ParallelAttachTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    ParallelAttachTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    struct ThreadData
+    {
+      RTCDevice device;
+      RTCScene scene;
+      std::atomic<size_t> errorCounter;
+    };
+
+    /* creates a triangle located at x = geomID */
+    static void placeTriangle(RTCGeometry geom, unsigned int geomID)
+    {
+      Vec3fa* vertices = (Vec3fa*) rtcGetGeometryBufferData(geom,RTC_BUFFER_TYPE_VERTEX,0);
+      vertices[0] = Vec3fa(float(geomID)+0.0f,0.0f,0.0f);
+      vertices[1] = Vec3fa(float(geomID)+1.0f,0.0f,0.0f);
+      vertices[2] = Vec3fa(float(geomID)+0.0f,1.0f,0.0f);
+      rtcCommitGeometry(geom);
+    }
+
+    static RTCGeometry createTriangle(RTCDevice device)
+    {
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3fa),3);
+      int* indices = (int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(int),1);
+      indices[0] = 0; indices[1] = 1; indices[2] = 2;
+      return geom;
+    }
+
+    /* each thread reserves small ranges of geometry IDs and attaches geometries placed by their ID */
+    static void attach_thread(void* ptr)
+    {
+      ThreadData* data = (ThreadData*) ptr;
+      for (size_t i=0; i<64; i++)
+      {
+        const unsigned int N = 4;
+        const unsigned int firstGeomID = rtcReserveGeometryIDs(data->scene,N);
+        if (firstGeomID == RTC_INVALID_GEOMETRY_ID) { data->errorCounter++; return; }
+        RTCGeometry geometries[N];
+        for (unsigned int j=0; j<N; j++) {
+          geometries[j] = createTriangle(data->device);
+          placeTriangle(geometries[j],firstGeomID+j);
+        }
+        rtcAttachGeometriesByID(data->scene,geometries,N,firstGeomID);
+        for (unsigned int j=0; j<N; j++)
+          rtcReleaseGeometry(geometries[j]);
+
+        /* check that rtcAttachGeometry does not hand out reserved IDs */
+        RTCGeometry geom = createTriangle(data->device);
+        const unsigned int geomID = rtcAttachGeometry(data->scene,geom);
+        if (geomID >= firstGeomID && geomID < firstGeomID+N) data->errorCounter++;
+        placeTriangle(geom,geomID);
+        rtcReleaseGeometry(geom);
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,sflags);
+      AssertNoError(device);
+
+      ThreadData data;
+      data.device = device;
+      data.scene = scene;
+      data.errorCounter = 0;
+      
+      std::vector<thread_t> threads;
+      for (size_t i=0; i<8; i++)
+        threads.push_back(createThread(attach_thread,&data));
+      for (size_t i=0; i<threads.size(); i++)
+        join(threads[i]);
+      AssertNoError(device);
+      if (data.errorCounter) return VerifyApplication::FAILED;
+
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* all geometry IDs got used exactly once */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (unsigned int geomID=0; geomID<8*64*5; geomID++)
+      {
+        RTCRayHit ray = makeRay(Vec3fa(float(geomID)+0.25f,0.25f,-1.0f),Vec3fa(0,0,1));
+        rtcIntersect1(scene,&context,&ray);
+        if (ray.hit.geomID != geomID) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct CommitScenesTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    CommitScenesTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* many small prototype scenes instanced by a single top-level scene */
+      const size_t numPrototypes = 100;
+      RandomSampler sampler;
+      RandomSampler_init(sampler,13);
+      std::vector<std::unique_ptr<VerifyScene>> prototypes;
+      for (size_t i=0; i<numPrototypes; i++) {
+        prototypes.push_back(std::unique_ptr<VerifyScene>(new VerifyScene(device,sflags)));
+        prototypes[i]->addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,0.4f,10+i%10);
+      }
+
+      VerifyScene scene(device,sflags);
+      for (size_t i=0; i<numPrototypes; i++)
+      {
+        RTCGeometry instance = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_INSTANCE);
+        rtcSetGeometryInstancedScene(instance,*prototypes[i]);
+        const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(float(i),0.0f,0.0f));
+        rtcSetGeometryTransform(instance,0,RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR,(float*)&xfm);
+        rtcCommitGeometry(instance);
+        rtcAttachGeometryByID(scene,instance,(unsigned)i);
+        rtcReleaseGeometry(instance);
+      }
+      AssertNoError(device);
+
+      /* the top-level scene is passed first to require reordering */
+      std::vector<RTCScene> scenes;
+      scenes.push_back(scene);
+      for (size_t i=0; i<numPrototypes; i++)
+        scenes.push_back(*prototypes[i]);
+
+      for (size_t iter=0; iter<3; iter++)
+      {
+        /* second iteration adds a larger sphere to a single prototype */
+        if (iter == 1) {
+          prototypes[7]->addSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,0.8f,10);
+          rtcCommitGeometry(rtcGetGeometry(scene,7));
+        }
+
+        rtcCommitScenes(scenes.data(),scenes.size());
+        AssertNoError(device);
+
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        for (size_t i=0; i<numPrototypes; i++)
+        {
+          RTCRayHit ray = makeRay(Vec3fa(float(i),10.0f,0.0f),Vec3fa(0,-1,0));
+          rtcIntersect1(scene,&context,&ray);
+          const float radius = iter >= 1 && i == 7 ? 0.8f : 0.4f;
+          if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID || ray.hit.instID[0] != i || abs(ray.ray.tfar-(10.0f-radius)) > 0.01f)
+            return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct UnifiedTopLevelTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    UnifiedTopLevelTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* the reference scene traverses the acceleration structures in sequence */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      if (!supportsIntersectMode(device0,imode))
+        return VerifyApplication::SKIPPED;
+      RTCDeviceRef device1 = rtcNewDevice((cfg+",unified_top_level=1").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      /* overlapping geometries of different types */
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      VerifyScene* scenes[2] = { &scene0, &scene1 };
+      for (size_t i=0; i<2; i++)
+      {
+        RandomSampler sampler;
+        RandomSampler_init(sampler,11);
+        scenes[i]->addSphere      (sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-2.0f,0.0f,0.0f),1.5f,50);
+        scenes[i]->addQuadSphere  (sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(-0.5f,0.5f,0.0f),1.5f,50);
+        scenes[i]->addSubdivSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(+1.0f,0.0f,0.5f),1.5f,8,4);
+        scenes[i]->addSphereHair  (sampler,RTC_BUILD_QUALITY_MEDIUM,Vec3fa(+2.5f,0.0f,0.0f),1.5f);
+        rtcCommitScene(*scenes[i]);
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler,12);
+      const unsigned int numRays = 256;
+      RTCRayHit rays0[numRays], rays1[numRays];
+      for (size_t j=0; j<16; j++)
+      {
+        for (size_t i=0; i<numRays; i++) {
+          const Vec3fa org = 8.0f*RandomSampler_get3D(sampler)-Vec3fa(4.0f);
+          const Vec3fa dir = 2.0f*RandomSampler_get3D(sampler)-Vec3fa(1.0f);
+          rays0[i] = rays1[i] = makeRay(org,dir);
+        }
+        IntersectWithMode(imode,ivariant,scene0,rays0,numRays);
+        IntersectWithMode(imode,ivariant,scene1,rays1,numRays);
+        for (size_t i=0; i<numRays; i++)
+        {
+          if (rays0[i].ray.tfar != rays1[i].ray.tfar)
+            return VerifyApplication::FAILED;
+          if ((ivariant & VARIANT_INTERSECT) && (rays0[i].hit.geomID != rays1[i].hit.geomID || rays0[i].hit.primID != rays1[i].hit.primID))
+            return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device0);
+      AssertNoError(device1);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct GarbageGeometryTest : public VerifyApplication::Test
   {
     GarbageGeometryTest (std::string name, int isa)
@@ -4178,6 +5261,7 @@ namespace embree
       push(new TestGroup(stringOfISA(isa),false,false));
       
       groups.top()->add(new MultipleDevicesTest("multiple_devices",isa));
+      groups.top()->add(new IsolatedDevicesTest("isolated_devices",isa));
 
       push(new TestGroup("get_bounds",true,true));
       for (auto gtype : gtypes_all)
@@ -4220,6 +5304,71 @@ namespace embree
         groups.top()->add(new BuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
       groups.pop();
       
+      push(new TestGroup("save_load_bvh",true,true));
+      for (auto sflags : sceneFlags) 
+        if (!(sflags.sflags & RTC_SCENE_FLAG_DYNAMIC))
+          groups.top()->add(new SaveLoadBVHTest(to_string(sflags),isa,sflags));
+      groups.pop();
+      
+      push(new TestGroup("async_commit",true,true));
+      for (auto sflags : sceneFlags) 
+        groups.top()->add(new AsyncCommitTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("progressive_commit",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new ProgressiveCommitTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("restructure",true,true));
+      for (auto sflags : sceneFlags) {
+        groups.top()->add(new RestructureTest(to_string(sflags)+".sah",isa,sflags,""));
+        groups.top()->add(new RestructureTest(to_string(sflags)+".morton",isa,sflags,",tri_builder=morton"));
+      }
+      groups.pop();
+
+      push(new TestGroup("incremental_update",true,true));
+      for (auto sflags : sceneFlagsDynamic) {
+        groups.top()->add(new IncrementalUpdateTest(to_string(sflags)+".triangles",isa,sflags,RTC_GEOMETRY_TYPE_TRIANGLE));
+        groups.top()->add(new IncrementalUpdateTest(to_string(sflags)+".quads",isa,sflags,RTC_GEOMETRY_TYPE_QUAD));
+      }
+      groups.pop();
+
+      push(new TestGroup("partial_refit",true,true));
+      for (auto sflags : sceneFlagsDynamic) {
+        groups.top()->add(new PartialRefitTest(to_string(sflags)+".triangles",isa,sflags,RTC_GEOMETRY_TYPE_TRIANGLE));
+        groups.top()->add(new PartialRefitTest(to_string(sflags)+".quads",isa,sflags,RTC_GEOMETRY_TYPE_QUAD));
+      }
+      groups.pop();
+
+      push(new TestGroup("refit_rebuild",true,true));
+      for (auto sflags : sceneFlagsDynamic) {
+        groups.top()->add(new RefitRebuildTest(to_string(sflags)+".triangles",isa,sflags,RTC_GEOMETRY_TYPE_TRIANGLE));
+        groups.top()->add(new RefitRebuildTest(to_string(sflags)+".quads",isa,sflags,RTC_GEOMETRY_TYPE_QUAD));
+      }
+      groups.pop();
+
+      push(new TestGroup("spatial_split_mblur",true,true));
+      groups.top()->add(new SpatialSplitMBlurTest("triangles",isa,RTC_GEOMETRY_TYPE_TRIANGLE,2));
+      groups.top()->add(new SpatialSplitMBlurTest("quads",isa,RTC_GEOMETRY_TYPE_QUAD,2));
+      groups.top()->add(new SpatialSplitMBlurTest("triangles_multi_segment",isa,RTC_GEOMETRY_TYPE_TRIANGLE,5));
+      groups.top()->add(new SpatialSplitMBlurTest("quads_multi_segment",isa,RTC_GEOMETRY_TYPE_QUAD,5));
+      groups.pop();
+
+      push(new TestGroup("presplit",true,true));
+      for (auto sflags : sceneFlags) {
+        groups.top()->add(new PresplitTest(to_string(sflags)+".triangles",isa,sflags,RTC_GEOMETRY_TYPE_TRIANGLE));
+        groups.top()->add(new PresplitTest(to_string(sflags)+".quads",isa,sflags,RTC_GEOMETRY_TYPE_QUAD));
+      }
+      groups.pop();
+
+      push(new TestGroup("build_bvh",true,true));
+      groups.top()->add(new BuildBVHTest("medium",isa,RTC_BUILD_QUALITY_MEDIUM,RTC_BUILD_FLAG_NONE,10000));
+      groups.top()->add(new BuildBVHTest("medium_clustering",isa,RTC_BUILD_QUALITY_MEDIUM,RTC_BUILD_FLAG_CLUSTERING,10000));
+      groups.top()->add(new BuildBVHTest("medium_clustering_small",isa,RTC_BUILD_QUALITY_MEDIUM,RTC_BUILD_FLAG_CLUSTERING,100));
+      groups.top()->add(new BuildBVHTest("high",isa,RTC_BUILD_QUALITY_HIGH,RTC_BUILD_FLAG_NONE,10000));
+      groups.pop();
+      
       push(new TestGroup("overlapping_primitives",true,true));
       for (auto sflags : sceneFlags)
         groups.top()->add(new OverlappingGeometryTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,clamp(int(intensity*10000),1000,100000)));
@@ -4253,6 +5402,27 @@ namespace embree
       }
       groups.pop();
 
+      push(new TestGroup("parallel_attach",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new ParallelAttachTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("commit_scenes",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new CommitScenesTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("unified_top_level",true,true));
+      for (auto imode : intersectModes) {
+        for (auto ivariant : intersectVariants) {
+          if (has_variant(imode,ivariant)) {
+            SceneFlags sflags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM);
+            groups.top()->add(new UnifiedTopLevelTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+          }
+        }
+      }
+      groups.pop();
+
       groups.top()->add(new GarbageGeometryTest("build_garbage_geom",isa));
 
       GeometryType gtypes_memory[] = { TRIANGLE_MESH, TRIANGLE_MESH_MB, QUAD_MESH, QUAD_MESH_MB, HAIR_GEOMETRY, HAIR_GEOMETRY_MB, LINE_GEOMETRY, LINE_GEOMETRY_MB };